@@ -0,0 +1,61 @@
+/**
+ * @file    bench.c
+ * @brief   Entry point of the host benchmarks.
+ * @details Runs every suite, or only the suites named on the command line.
+ *          See the Makefile for how the kernel is built for the host.
+ * @author  Manuel Burnay
+ * @date    2026.10.16 (Created)
+ * @date    2026.10.16 (Last Modified)
+ */
+
+#include <string.h>
+#include "bench.h"
+#include "k_defs.h"
+
+/** @brief  Benchmark suites, in the order they run. */
+const bench_suite_t suite[] = {
+    { "pool", "Message and bitmap allocation vs pool occupancy", &bench_pool },
+    { "timer", "Timing wheel operations vs armed timers", &bench_timer },
+    { "inherit", "Request latency with and without priority inheritance", &bench_inherit },
+    { "loan", "Zero-copy loaned messages vs copied messages", &bench_loan },
+    { "select", "Selective and any-source receives vs queue depth", &bench_select },
+    { "chan", "SPSC channels vs send/recv through a box", &bench_chan },
+    { "prio", "Control message latency behind a bulk backlog", &bench_prio },
+    { "sched", "Schedule() vs the linear queue scan, per amount of priority levels", &bench_sched },
+    { "jitter", "Release jitter of a 1 ms periodic process using sleep_until", &bench_jitter },
+    { "tickless", "SysTick interrupts of the tickless mode vs the periodic tick", &bench_tickless },
+};
+
+#define SUITES  (sizeof(suite)/sizeof(suite[0]))
+
+/**
+ * @brief   Checks if a suite was selected on the command line.
+ */
+bool Selected(const char* name, int argc, char** argv)
+{
+    int i;
+
+    if (argc < 2)   return true;
+
+    for (i = 1; i < argc; i++) {
+        if (strcmp(name, argv[i]) == 0) return true;
+    }
+
+    return false;
+}
+
+int main(int argc, char** argv)
+{
+    int i;
+
+    host_map_ppb();
+
+    for (i = 0; i < SUITES; i++) {
+        if (Selected(suite[i].name, argc, argv)) {
+            printf("\n== %s (MSG_MAX %d): %s\n", suite[i].name, MSG_MAX, suite[i].about);
+            suite[i].run();
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,47 @@
+/**
+ * @file    bench.h
+ * @brief   Definitions and function prototypes shared by the host benchmarks.
+ * @details The benchmarks build the kernel's sources for the host
+ *          and time them with the host's monotonic clock.
+ *          Results are relative: they show how a cost scales with load,
+ *          not how long an operation takes on the target.
+ * @author  Manuel Burnay
+ * @date    2026.10.16 (Created)
+ * @date    2026.10.16 (Last Modified)
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define BENCH_REPEATS   100000  /// Times a timed operation is repeated by default.
+
+/**
+ * @brief   Benchmark suite structure.
+ * @details Every suite measures what one change request asked for.
+ */
+typedef struct bench_suite_ {
+    const char* name;   /**< Name used to select the suite from the command line. */
+    const char* about;  /**< One-line description printed before the results. */
+    void        (*run)();   /**< Function that runs the suite and prints its results. */
+} bench_suite_t;
+
+uint64_t host_ns();
+void host_map_ppb();
+
+int printf(const char* format, ...);
+
+void bench_pool();
+void bench_timer();
+void bench_inherit();
+void bench_loan();
+void bench_select();
+void bench_chan();
+void bench_prio();
+void bench_sched();
+void bench_jitter();
+void bench_tickless();
+
+#endif  // BENCH_H
@@ -0,0 +1,131 @@
+/**
+ * @file    bench_chan.c
+ * @brief   Benchmarks SPSC channels against messages sent through a box.
+ * @details Items go through a channel's ring the way chan_send() and chan_recv()
+ *          move them when the consumer isn't asleep, with no kernel call.
+ *          Messages go through k_MsgDeliver() and k_MsgFetch(), the kernel side
+ *          of send() and recv(). The host has no trap to time, so the cost of
+ *          the two kernel calls a message takes on the target is left out.
+ * @author  Manuel Burnay
+ * @date    2026.10.16 (Created)
+ * @date    2026.10.16 (Last Modified)
+ */
+
+#include "bench.h"
+#include "k_messaging.h"
+#include "k_channel.h"
+#include "spsc.h"
+
+#define RECEIVER_BOX    1
+#define SENDER_BOX      2
+
+static const uint32_t item_size[] = {4, 16, 64};    /// Item sizes measured (in Bytes).
+
+static pcb_t consumer = {.id = 1};
+static pcb_t producer = {.id = 2};
+
+static uint8_t tx_item[MSG_MAX_SIZE];
+static uint8_t rx_item[MSG_MAX_SIZE];
+
+volatile uint32_t chan_sink;    /// Keeps the received items from being optimized out.
+
+/**
+ * @brief   Times items going through a channel.
+ * @param   [in] size: Size of the items (in Bytes).
+ * @return  Average time of an item (in ns).
+ * @details The producer fills the ring and then the consumer empties it,
+ *          so both sides work in bursts of the ring's size.
+ */
+static uint64_t TimeChannel(uint32_t size)
+{
+    spsc_ring_t* ring = k_ChanCreate(size, &consumer);
+    uint32_t sent = 0, i;
+    uint64_t start, item;
+
+    k_ChanAttach(ring->id, &producer);
+
+    start = host_ns();
+
+    while (sent < BENCH_REPEATS) {
+        for (i = 0; i <= ring->mask; i++) {
+            tx_item[0] = (uint8_t)(sent + i);
+            spsc_push(ring, tx_item);
+
+            // chan_send() only notifies a waiting consumer
+            if (ring->waiting)  k_ChanNotify(ring->id, &producer);
+        }
+
+        for (i = 0; i <= ring->mask; i++) {
+            spsc_pop(ring, rx_item);
+            chan_sink += rx_item[0];
+        }
+
+        sent += ring->mask + 1;
+    }
+
+    item = (host_ns() - start) / sent;
+
+    k_ChanClose(ring->id, &producer);
+    k_ChanClose(ring->id, &consumer);
+
+    return item;
+}
+
+/**
+ * @brief   Times messages going through a box.
+ * @param   [in] size: Size of the messages (in Bytes).
+ * @return  Average time of a message (in ns).
+ * @details Every message is received before the next one is sent,
+ *          so the larger messages don't run their size class out.
+ */
+static uint64_t TimeMessages(uint32_t size)
+{
+    pmsg_t tx = {.dst = RECEIVER_BOX, .src = SENDER_BOX, .data = tx_item};
+    pmsg_t rx = {.dst = RECEIVER_BOX, .data = rx_item};
+    size_t retsize;
+    uint64_t start = host_ns();
+    int i;
+
+    for (i = 0; i < BENCH_REPEATS; i++) {
+        tx_item[0] = (uint8_t)i;
+        tx.size = size;
+        tx.flags = MSG_OWN_KERNEL;
+        k_MsgDeliver(&tx, &retsize);
+
+        rx.src = ANY_BOX;
+        rx.size = size;
+        rx.flags = MSG_OWN_KERNEL;
+        k_MsgFetch(&rx, &retsize);
+        chan_sink += rx_item[0];
+    }
+
+    return (host_ns() - start) / BENCH_REPEATS;
+}
+
+/**
+ * @brief   Runs the channel benchmark.
+ */
+void bench_chan()
+{
+    uint64_t chan, msg;
+    uint32_t s;
+
+    k_MsgInit();
+    k_ChanInit();
+    k_MsgBoxBind(RECEIVER_BOX, &consumer);
+    k_MsgBoxBind(SENDER_BOX, &producer);
+
+    printf("%-6s %26s %26s\n", "size", "channel", "send/recv");
+
+    for (s = 0; s < sizeof(item_size)/sizeof(item_size[0]); s++) {
+        chan = TimeChannel(item_size[s]);
+        msg = TimeMessages(item_size[s]);
+
+        printf("%5uB %6llu ns %10llu item/s %6llu ns %10llu item/s\n", item_size[s],
+               (unsigned long long)chan, (unsigned long long)(1000000000u / (chan ? chan : 1)),
+               (unsigned long long)msg, (unsigned long long)(1000000000u / (msg ? msg : 1)));
+    }
+
+    k_MsgBoxUnbind(SENDER_BOX, &producer);
+    k_MsgBoxUnbind(RECEIVER_BOX, &consumer);
+}
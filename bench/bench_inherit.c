@@ -0,0 +1,119 @@
+/**
+ * @file    bench_inherit.c
+ * @brief   Measures a client's request latency with and without priority inheritance.
+ * @details A HIGH_PRIORITY client sends a request to a box owned by a
+ *          LOWEST_PRIORITY server, while medium priority processes become ready.
+ *          The kernel's scheduler picks the process that runs on every tick,
+ *          so the latency is counted in ticks instead of timed.
+ *          Without inheritance, every medium process delays the reply.
+ *          With it, the server runs at the client's priority until it replies.
+ * @author  Manuel Burnay
+ * @date    2026.10.16 (Created)
+ * @date    2026.10.16 (Last Modified)
+ */
+
+#include "bench.h"
+#include "k_messaging.h"
+#include "k_processes.h"
+#include "k_scheduler.h"
+#include "k_timer.h"
+
+#define SERVER_BOX      1
+#define SERVE_TICKS     5       /// Ticks the server runs for before it replies.
+#define MEDIUM_TICKS    20      /// Ticks every medium priority process runs for.
+#define MEDIUM_MAX      (PID_MAX-3) /// Medium priority processes (all PCBs but the idle, client and server).
+
+extern pcb_t proc_table[PID_MAX];
+
+static uint32_t work[PID_MAX];  /// Ticks every process still has to run for.
+
+/**
+ * @brief   Readies a process on a priority.
+ */
+static void Ready(pcb_t* pcb, priority_t priority, uint32_t ticks)
+{
+    pcb->base_priority = priority;
+    pcb->state = WAITING_TO_RUN;
+    LinkPCB(pcb, priority);
+    work[pcb->id] = ticks;
+}
+
+/**
+ * @brief   Runs a request until the client gets its reply.
+ * @param   [in] mediums: Medium priority processes that become ready with the request.
+ * @param   [in] inherit: Whether the client lends its priority to the server.
+ * @return  Ticks between the request and the reply.
+ */
+static uint32_t RequestLatency(uint32_t mediums, bool inherit)
+{
+    pcb_t* idle = &proc_table[0];
+    pcb_t* server = &proc_table[1];
+    pcb_t* client = &proc_table[2];
+    pcb_t* pcb;
+    uint32_t i, ticks = 0;
+
+    process_init();
+    scheduler_init();
+    k_MsgInit();
+
+    Ready(idle, IDLE_LEVEL, 0);
+    Ready(server, LOWEST_PRIORITY, SERVE_TICKS);
+    k_MsgBoxBind(SERVER_BOX, server);
+
+    // The client sends its request and blocks on the reply
+    client->base_priority = client->priority = HIGH_PRIORITY;
+    client->state = BLOCKED;
+    if (inherit)    k_MsgRequestStart(client, SERVER_BOX);
+
+    for (i = 0; i < mediums; i++) {
+        Ready(&proc_table[3+i], USER_PRIORITY, MEDIUM_TICKS);
+    }
+
+    while (client->state == BLOCKED) {
+        pcb = Schedule();
+        ticks++;
+
+        if (pcb == idle || --work[pcb->id] != 0)    continue;
+
+        if (pcb == server) {
+            if (inherit)    k_MsgRequestEnd(client);
+            WakePCB(client);
+        }
+        else {
+            BlockPCB(pcb, BLOCKED);
+        }
+    }
+
+    // The box and the scheduler's queues are left empty for the next request
+    k_MsgBoxUnbind(SERVER_BOX, server);
+
+    for (i = 0; i < PID_MAX; i++) {
+        if (proc_table[i].state == WAITING_TO_RUN)  UnlinkPCB(&proc_table[i]);
+    }
+
+    return ticks;
+}
+
+/**
+ * @brief   Runs the priority inheritance benchmark.
+ * @details The worst case is the most medium priority processes
+ *          the PCB table can hold.
+ */
+void bench_inherit()
+{
+    uint32_t m, with, without, worst_with = 0, worst_without = 0;
+
+    printf("%-8s %16s %18s\n", "mediums", "with inheritance", "without inheritance");
+
+    for (m = 0; m <= MEDIUM_MAX; m++) {
+        with = RequestLatency(m, true);
+        without = RequestLatency(m, false);
+
+        if (with > worst_with)          worst_with = with;
+        if (without > worst_without)    worst_without = without;
+
+        printf("%8u %10u ticks %12u ticks\n", m, with, without);
+    }
+
+    printf("%-8s %10u ticks %12u ticks\n", "worst", worst_with, worst_without);
+}
@@ -0,0 +1,149 @@
+/**
+ * @file    bench_jitter.c
+ * @brief   Measures the release jitter of a 1 ms periodic process that sleeps until its next release.
+ * @details The process sleeps until an absolute kernel time the way sleep_until() does,
+ *          and the kernel time is moved forward one tick at a time with k_TimeAdvance(),
+ *          like the SysTick handler does. The release latency is the time from the tick
+ *          to Schedule() picking the process, so it includes the timer expiry and the wake-up.
+ *          Other timers are armed with random delays, and the ones that expire
+ *          on the same tick as the process are what makes its release late.
+ *          Since the wake-up time is absolute, releases never drift in ticks;
+ *          a release that comes a tick late is counted as such.
+ * @author  Manuel Burnay
+ * @date    2026.10.16 (Created)
+ * @date    2026.10.16 (Last Modified)
+ */
+
+#include "bench.h"
+#include "k_processes.h"
+#include "k_scheduler.h"
+#include "k_timer.h"
+
+#define PERIOD          1       /// Period of the process (in ticks, 1 ms).
+#define RELEASES        20000   /// Releases timed per amount of armed timers.
+#define TIMERS_MAX      10000   /// Most other timers armed at once.
+#define DELAY_MAX       1000    /// Longest delay another timer is armed for (in ticks).
+
+static const uint32_t armed[] = {0, 100, 1000, 10000};  /// Amounts of other armed timers measured.
+
+extern pcb_t proc_table[PID_MAX];
+extern pcb_t* running;
+
+static ktimer_t timers[TIMERS_MAX];
+static uint32_t latency[RELEASES];
+static uint32_t seed;
+
+/**
+ * @brief   Re-arms another timer with a pseudo-random delay between 1 and DELAY_MAX ticks.
+ */
+static void Rearm(ktimer_t* tmr)
+{
+    seed = seed*1664525 + 1013904223;
+    k_TimerStart(tmr, 1 + (seed >> 8) % DELAY_MAX);
+}
+
+/**
+ * @brief   Puts the running process to sleep until an absolute kernel time.
+ * @param   [in] tick: Kernel time (in ticks) to wake up at.
+ * @details Same as k_sleepUntilCall(), which isn't built for the host
+ *          along with the rest of the kernel call handlers.
+ */
+static void SleepUntil(uint32_t tick)
+{
+    int32_t delta = (int32_t)(tick - k_GetTime());
+
+    if (delta > 0) {
+        k_TimerSetup(&running->alarm, &k_TimerWake, running);
+        k_TimerStart(&running->alarm, (uint32_t)delta);
+        BlockPCB(running, SLEEPING);
+    }
+}
+
+/**
+ * @brief   Sorts the release latencies in increasing order (Shell sort).
+ */
+static void SortLatency()
+{
+    uint32_t gap, i, j, v;
+
+    for (gap = RELEASES/2; gap > 0; gap /= 2) {
+        for (i = gap; i < RELEASES; i++) {
+            v = latency[i];
+            for (j = i; j >= gap && latency[j-gap] > v; j -= gap)   latency[j] = latency[j-gap];
+            latency[j] = v;
+        }
+    }
+}
+
+/**
+ * @brief   Releases the periodic process RELEASES times with other timers armed.
+ * @param   [in] timers_armed: Amount of other timers armed.
+ * @return  Amount of releases that came a tick or more late.
+ */
+static uint32_t Release(uint32_t timers_armed)
+{
+    pcb_t* idle = &proc_table[0];
+    pcb_t* task = &proc_table[1];
+    uint32_t release, late = 0, i;
+    uint64_t start;
+
+    seed = 1;
+
+    process_init();
+    scheduler_init();
+    k_TimerInit();
+
+    for (i = 0; i < timers_armed; i++) {
+        k_TimerSetup(&timers[i], &Rearm, NULL);
+        Rearm(&timers[i]);
+    }
+
+    idle->state = WAITING_TO_RUN;
+    LinkPCB(idle, IDLE_LEVEL);
+    task->base_priority = HIGH_PRIORITY;
+    task->state = WAITING_TO_RUN;
+    LinkPCB(task, HIGH_PRIORITY);
+
+    running = Schedule();
+    release = k_GetTime();
+
+    for (i = 0; i < RELEASES; i++) {
+        release += PERIOD;
+        SleepUntil(release);
+
+        // Ticks go by on the idle process until the task is picked again
+        start = host_ns();
+        do {
+            k_TimeAdvance(1);
+            running = Schedule();
+        } while (running != task);
+        latency[i] = (uint32_t)(host_ns() - start);
+
+        if (k_GetTime() != release) late++;
+    }
+
+    UnlinkPCB(task);
+    UnlinkPCB(idle);
+
+    return late;
+}
+
+/**
+ * @brief   Runs the release jitter benchmark.
+ */
+void bench_jitter()
+{
+    uint32_t a, late;
+
+    printf("%-8s %10s %10s %10s %10s %10s %6s\n",
+           "armed", "min", "median", "99%", "99.9%", "max", "late");
+
+    for (a = 0; a < sizeof(armed)/sizeof(armed[0]); a++) {
+        late = Release(armed[a]);
+        SortLatency();
+
+        printf("%8u %7u ns %7u ns %7u ns %7u ns %7u ns %6u\n", armed[a],
+               latency[0], latency[RELEASES/2], latency[RELEASES*99/100],
+               latency[RELEASES*999/1000], latency[RELEASES-1], late);
+    }
+}
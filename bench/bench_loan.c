@@ -0,0 +1,173 @@
+/**
+ * @file    bench_loan.c
+ * @brief   Benchmarks zero-copy loaned messages against copied messages.
+ * @details A copied message goes from the sender's buffer into the pool on send,
+ *          and from the pool into the receiver's buffer on receive.
+ *          A loaned message is written in a pool buffer and read from it in place.
+ *          Writing and reading the payload costs the same on both paths,
+ *          so only the messaging itself is timed, except for the telemetry case:
+ *          a 64 Byte record the sender fills and the receiver reads whole.
+ *          The loaned path looks its buffer up on send and on release,
+ *          like send_loaned() and msg_release() do.
+ *          The host's memcpy is much faster than the target's,
+ *          so these results understate what the copies cost on the target.
+ * @author  Manuel Burnay
+ * @date    2026.10.16 (Created)
+ * @date    2026.10.16 (Last Modified)
+ */
+
+#include "bench.h"
+#include "k_messaging.h"
+
+#define SENDER_BOX      2
+#define RECEIVER_BOX    1
+
+#define TELEMETRY_SIZE  64  /// Size of a telemetry record (in Bytes).
+
+static const uint32_t msg_size[] = {8, 64, 512};    /// Message sizes measured (in Bytes).
+
+static pcb_t sender = {.id = 2};
+static pcb_t receiver = {.id = 1};
+
+static uint8_t tx_buffer[MSG_MAX_SIZE];
+static uint8_t rx_buffer[MSG_MAX_SIZE];
+
+volatile uint32_t loan_sink;    /// Keeps the received messages from being optimized out.
+
+/**
+ * @brief   Fills a message payload, the way a sender writes a telemetry record.
+ */
+static void Write(uint8_t* data, uint32_t size, uint32_t seq)
+{
+    uint32_t i;
+
+    for (i = 0; i < size; i++)  data[i] = (uint8_t)(seq + i);
+}
+
+/**
+ * @brief   Reads a whole message payload, the way a receiver reads a telemetry record.
+ */
+static void Read(const uint8_t* data, uint32_t size)
+{
+    uint32_t i, sum = 0;
+
+    for (i = 0; i < size; i++)  sum += data[i];
+
+    loan_sink += sum;
+}
+
+/**
+ * @brief   Times sending and receiving messages that are copied.
+ * @param   [in] size: Size of the messages (in Bytes).
+ * @param   [in] whole: Whether the whole payload is written and read.
+ * @return  Average time of a message (in ns).
+ */
+static uint64_t TimeCopied(uint32_t size, bool whole)
+{
+    pmsg_t tx = {.dst = RECEIVER_BOX, .src = SENDER_BOX, .data = tx_buffer};
+    pmsg_t rx = {.dst = RECEIVER_BOX, .data = rx_buffer};
+    size_t retsize;
+    uint64_t start = host_ns();
+    int i;
+
+    for (i = 0; i < BENCH_REPEATS; i++) {
+        Write(tx.data, whole ? size : 1, i);
+        tx.size = size;
+        tx.flags = MSG_OWN_KERNEL;
+        k_MsgDeliver(&tx, &retsize);
+
+        rx.src = ANY_BOX;
+        rx.size = size;
+        rx.flags = MSG_OWN_KERNEL;
+        k_MsgFetch(&rx, &retsize);
+        Read(rx.data, whole ? size : 1);
+    }
+
+    return (host_ns() - start) / BENCH_REPEATS;
+}
+
+/**
+ * @brief   Times sending and receiving messages that are loaned.
+ * @param   [in] size: Size of the messages (in Bytes).
+ * @param   [in] whole: Whether the whole payload is written and read.
+ * @return  Average time of a message (in ns).
+ */
+static uint64_t TimeLoaned(uint32_t size, bool whole)
+{
+    pmsg_t* tx;
+    pmsg_t rx = {.dst = RECEIVER_BOX};
+    size_t retsize;
+    uint64_t start = host_ns();
+    int i;
+
+    for (i = 0; i < BENCH_REPEATS; i++) {
+        tx = k_MsgLoan(size, &sender);
+        Write(tx->data, whole ? size : 1, i);
+        tx = k_MsgLoanLookup(tx->data, &sender);
+        tx->dst = RECEIVER_BOX;
+        tx->src = SENDER_BOX;
+        k_MsgDeliver(tx, &retsize);
+
+        rx.src = ANY_BOX;
+        rx.flags = MSG_OWN_BORROW;
+        k_MsgFetch(&rx, &retsize);
+        Read(rx.data, whole ? size : 1);
+        k_MsgRelease(k_MsgLoanLookup(rx.data, &receiver));
+    }
+
+    return (host_ns() - start) / BENCH_REPEATS;
+}
+
+/**
+ * @brief   Times looking up the pool message of a loaned buffer.
+ * @param   [in] size: Size of the loaned message (in Bytes).
+ * @return  Average time of a lookup (in ns).
+ */
+static uint64_t TimeLookup(uint32_t size)
+{
+    pmsg_t* msg = k_MsgLoan(size, &sender);
+    uint64_t start = host_ns(), lookup;
+    int i;
+
+    for (i = 0; i < BENCH_REPEATS; i++) loan_sink += k_MsgLoanLookup(msg->data, &sender)->id;
+
+    lookup = (host_ns() - start) / BENCH_REPEATS;
+
+    k_MsgRelease(msg);
+
+    return lookup;
+}
+
+/**
+ * @brief   Prints the copied and loaned times of a message size.
+ */
+static void Print(const char* name, uint32_t size, uint64_t copied, uint64_t loaned)
+{
+    printf("%-10s %5uB %6llu ns %9llu msg/s %6llu ns %9llu msg/s %6llu ns\n", name, size,
+           (unsigned long long)copied, (unsigned long long)(1000000000u / (copied ? copied : 1)),
+           (unsigned long long)loaned, (unsigned long long)(1000000000u / (loaned ? loaned : 1)),
+           (unsigned long long)TimeLookup(size));
+}
+
+/**
+ * @brief   Runs the loaned message benchmark.
+ */
+void bench_loan()
+{
+    uint32_t s;
+
+    k_MsgInit();
+    k_MsgBoxBind(RECEIVER_BOX, &receiver);
+    k_MsgBoxBind(SENDER_BOX, &sender);
+
+    printf("%-10s %6s %24s %24s %9s\n", "payload", "size", "copied", "loaned", "lookup");
+
+    for (s = 0; s < sizeof(msg_size)/sizeof(msg_size[0]); s++) {
+        Print("untouched", msg_size[s], TimeCopied(msg_size[s], false), TimeLoaned(msg_size[s], false));
+    }
+
+    Print("telemetry", TELEMETRY_SIZE, TimeCopied(TELEMETRY_SIZE, true), TimeLoaned(TELEMETRY_SIZE, true));
+
+    k_MsgBoxUnbind(SENDER_BOX, &sender);
+    k_MsgBoxUnbind(RECEIVER_BOX, &receiver);
+}
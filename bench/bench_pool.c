@@ -0,0 +1,88 @@
+/**
+ * @file    bench_pool.c
+ * @brief   Benchmarks message and bitmap allocation against pool occupancy.
+ * @details Allocation should cost the same however full the pool is.
+ *          Messages come off the size-class free lists, while PIDs, boxes
+ *          and timers are found with a word-at-a-time bitmap search.
+ *          Build with different MSG_MAX values to see how the pool size affects it
+ *          (the Makefile's "run" target does).
+ * @author  Manuel Burnay
+ * @date    2026.10.16 (Created)
+ * @date    2026.10.16 (Last Modified)
+ */
+
+#include "bench.h"
+#include "k_messaging.h"
+#include "bitmap.h"
+
+static const uint32_t occupancy[] = {0, 25, 50, 75, 90, 100};   /// Pool occupancies measured (in %).
+
+static pmsg_t*  held[MSG_MAX];  /// Messages held to fill the pool.
+static bitmap_t map[MSG_BITMAP_SIZE];
+
+volatile uint32_t pool_sink;    /// Keeps the timed searches from being optimized out.
+
+/**
+ * @brief   Times an allocation and de-allocation pair of a class 0 message.
+ * @return  Average time of a pair (in ns).
+ */
+static uint64_t TimeMsgAlloc()
+{
+    pmsg_t* msg;
+    uint64_t start = host_ns();
+    int i;
+
+    for (i = 0; i < BENCH_REPEATS; i++) {
+        msg = k_pMsgAllocate(1);
+        if (msg != NULL)    k_pMsgDeallocate(&msg);
+    }
+
+    return (host_ns() - start) / BENCH_REPEATS;
+}
+
+/**
+ * @brief   Times the search for the first free bit of a bitmap
+ *          as big as the message pool.
+ * @return  Average time of a search (in ns).
+ */
+static uint64_t TimeBitmapSearch()
+{
+    uint64_t start = host_ns();
+    int i;
+
+    for (i = 0; i < BENCH_REPEATS; i++) {
+        pool_sink += FindClear(map, 0, MSG_MAX);
+    }
+
+    return (host_ns() - start) / BENCH_REPEATS;
+}
+
+/**
+ * @brief   Runs the pool allocation benchmark.
+ * @details The pool is filled with the smallest messages, so they spill into
+ *          the larger classes once class 0 runs out, like on a busy system.
+ *          The bitmap is filled from its lowest bit, which is the worst case
+ *          for a first-fit search.
+ */
+void bench_pool()
+{
+    uint32_t p, i, n;
+
+    printf("%-10s %14s %14s\n", "occupancy", "msg alloc/free", "bitmap search");
+
+    for (p = 0; p < sizeof(occupancy)/sizeof(occupancy[0]); p++) {
+        n = (occupancy[p] * MSG_MAX) / 100;
+
+        k_MsgInit();
+        for (i = 0; i < n; i++) held[i] = k_pMsgAllocate(1);
+
+        ClearBitRange(map, 0, MSG_MAX);
+        SetBitRange(map, 0, n);
+
+        printf("%9u%% %11llu ns %11llu ns\n", occupancy[p],
+               (unsigned long long)TimeMsgAlloc(),
+               (unsigned long long)TimeBitmapSearch());
+
+        for (i = 0; i < n; i++) k_pMsgDeallocate(&held[i]);
+    }
+}
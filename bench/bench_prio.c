@@ -0,0 +1,113 @@
+/**
+ * @file    bench_prio.c
+ * @brief   Measures the latency of a control message queued behind bulk messages.
+ * @details A box holds a backlog of bulk messages when a control message
+ *          is sent to it. The receiver takes messages until it gets the control one.
+ *          With message priorities the control message is received first,
+ *          without them it waits for the whole backlog.
+ * @author  Manuel Burnay
+ * @date    2026.10.16 (Created)
+ * @date    2026.10.16 (Last Modified)
+ */
+
+#include "bench.h"
+#include "k_messaging.h"
+
+#define RECEIVER_BOX    1
+#define BULK_BOX        2
+#define CONTROL_BOX     3
+#define BACKLOG         30      /// Bulk messages queued ahead of the control message.
+#define PRIO_REPEATS    10000   /// Control messages timed.
+
+extern pmsgbox_t msgbox[BOXID_MAX];
+
+static pcb_t receiver = {.id = 1};
+
+/**
+ * @brief   Sends a one byte message to the receiver's box.
+ */
+static void Send(pmbox_t src, uint8_t prio)
+{
+    uint8_t data = 0;
+    pmsg_t msg = {.dst = RECEIVER_BOX, .src = src, .data = &data, .size = 1,
+                  .flags = MSG_OWN_KERNEL, .prio = prio};
+    size_t retsize;
+
+    k_MsgDeliver(&msg, &retsize);
+}
+
+/**
+ * @brief   Receives a message from any source.
+ * @return  Box the message came from.
+ */
+static pmbox_t Recv()
+{
+    uint8_t data;
+    pmsg_t msg = {.dst = RECEIVER_BOX, .src = ANY_BOX, .data = &data, .size = 1,
+                  .flags = MSG_OWN_KERNEL};
+    size_t retsize;
+
+    k_MsgFetch(&msg, &retsize);
+
+    return msg.src;
+}
+
+/**
+ * @brief   Times control messages sent behind a bulk backlog.
+ * @param   [in] prio: Priority of the control message.
+ * @param   [out] ahead: Messages received before the control message.
+ * @param   [out] worst: Longest time between sending the control message and receiving it (in ns).
+ * @return  Average time between sending the control message and receiving it (in ns).
+ */
+static uint64_t TimeControl(uint8_t prio, uint32_t* ahead, uint64_t* worst)
+{
+    uint64_t start, latency, total = 0;
+    uint32_t i, n;
+
+    *worst = 0;
+
+    for (i = 0; i < PRIO_REPEATS; i++) {
+        for (n = 0; n < BACKLOG; n++)   Send(BULK_BOX, 0);
+
+        start = host_ns();
+
+        Send(CONTROL_BOX, prio);
+        for (n = 0; Recv() != CONTROL_BOX; n++);
+
+        latency = host_ns() - start;
+
+        // The rest of the backlog is drained out of the timing
+        while (k_MsgHead(&msgbox[RECEIVER_BOX]) != NULL)    Recv();
+
+        total += latency;
+        if (latency > *worst)   *worst = latency;
+        *ahead = n;
+    }
+
+    return total / PRIO_REPEATS;
+}
+
+/**
+ * @brief   Runs the message priority benchmark.
+ */
+void bench_prio()
+{
+    uint64_t avg, worst;
+    uint32_t ahead;
+
+    k_MsgInit();
+    k_MsgBoxBind(RECEIVER_BOX, &receiver);
+    k_MsgBoxSetDepth(RECEIVER_BOX, 0, &receiver);
+
+    printf("%-16s %6s %12s %12s\n", "control prio", "ahead", "average", "worst");
+
+    avg = TimeControl(0, &ahead, &worst);
+    printf("%-16s %6u %9llu ns %9llu ns\n", "0 (same as bulk)", ahead,
+           (unsigned long long)avg, (unsigned long long)worst);
+
+    avg = TimeControl(MSG_PRIORITIES-1, &ahead, &worst);
+    printf("%-16u %6u %9llu ns %9llu ns\n", MSG_PRIORITIES-1, ahead,
+           (unsigned long long)avg, (unsigned long long)worst);
+
+    k_MsgBoxUnbind(RECEIVER_BOX, &receiver);
+}
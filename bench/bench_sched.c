@@ -0,0 +1,109 @@
+/**
+ * @file    bench_sched.c
+ * @brief   Benchmarks Schedule() against the linear scan of the process queues it replaced.
+ * @details The suite is built once per amount of priority levels (see the Makefile),
+ *          since PRIORITY_LEVELS sizes the process queues and the ready bitmap.
+ *          One process is made ready on a level, next to the idle process,
+ *          and the next process to run is picked from it over and over.
+ *          The linear scan walks every empty queue above that level,
+ *          so its cost grows with the level and the amount of levels.
+ *          Schedule() should cost the same from 5 to 256 levels,
+ *          across the one and the many groups of the two-level bitmap.
+ * @author  Manuel Burnay
+ * @date    2026.10.16 (Created)
+ * @date    2026.10.16 (Last Modified)
+ */
+
+#include "bench.h"
+#include "k_processes.h"
+#include "k_scheduler.h"
+
+extern pcb_t proc_table[PID_MAX];
+extern pcb_t* ProcessQueue[PROCESS_QUEUES];
+
+pcb_t* volatile sched_sink;     /// Keeps the picked processes from being optimized out.
+
+/**
+ * @brief   Determines which PCB should run next, the way Schedule() did before the ready bitmap.
+ * @return  Pointer to PCB of the next process that should run.
+ * @details Iterates through the process queues until one isn't empty.
+ */
+static pcb_t* LinearSchedule()
+{
+    pcb_t* front;
+    pcb_t* retval = NULL;
+    int i = 0;
+
+    while (i < PRIORITY_LEVELS && retval == NULL) {
+        front = ProcessQueue[i];
+        if (front != NULL) {
+            retval = front;
+            ProcessQueue[i] = front->next;
+        }
+        i++;
+    }
+
+    if (retval == NULL) retval = ProcessQueue[IDLE_LEVEL];
+
+    return retval;
+}
+
+/**
+ * @brief   Times picking the next process with a scheduling function.
+ * @param   [in] pick: Scheduling function.
+ * @return  Average time of a pick (in ns).
+ */
+static uint64_t TimePick(pcb_t* (*pick)())
+{
+    uint64_t start = host_ns();
+    int i;
+
+    for (i = 0; i < BENCH_REPEATS; i++) sched_sink = pick();
+
+    return (host_ns() - start) / BENCH_REPEATS;
+}
+
+/**
+ * @brief   Times both scheduling functions with one process ready on a level.
+ * @param   [in] name: Name the level is printed with.
+ * @param   [in] lvl: Level of the ready process. IDLE_LEVEL for none but the idle process.
+ */
+static void TimeLevel(const char* name, priority_t lvl)
+{
+    pcb_t* idle = &proc_table[0];
+    pcb_t* pcb = &proc_table[1];
+    uint64_t bitmap, linear;
+
+    process_init();
+    scheduler_init();
+
+    idle->state = WAITING_TO_RUN;
+    LinkPCB(idle, IDLE_LEVEL);
+
+    if (lvl != IDLE_LEVEL) {
+        pcb->state = WAITING_TO_RUN;
+        LinkPCB(pcb, lvl);
+    }
+
+    bitmap = TimePick(&Schedule);
+    linear = TimePick(&LinearSchedule);
+
+    printf("%-8u %-10s %4u %9llu ns %9llu ns\n", PRIORITY_LEVELS, name, lvl,
+           (unsigned long long)bitmap, (unsigned long long)linear);
+
+    if (lvl != IDLE_LEVEL)  UnlinkPCB(pcb);
+    UnlinkPCB(idle);
+}
+
+/**
+ * @brief   Runs the scheduler benchmark.
+ */
+void bench_sched()
+{
+    printf("%-8s %-10s %4s %12s %12s\n", "levels", "ready", "lvl", "Schedule()", "linear scan");
+
+    TimeLevel("high", HIGH_PRIORITY);
+    TimeLevel("user", USER_PRIORITY);
+    TimeLevel("lowest", LOWEST_PRIORITY);
+    TimeLevel("idle only", IDLE_LEVEL);
+}
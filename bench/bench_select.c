@@ -0,0 +1,87 @@
+/**
+ * @file    bench_select.c
+ * @brief   Benchmarks selective receives against the depth of a box' queue.
+ * @details 16 producers keep a box' queue at a set depth. A selective receive
+ *          takes the oldest message of one producer, which takes the same time
+ *          however deep the queue is, as does an any-source receive.
+ * @author  Manuel Burnay
+ * @date    2026.10.16 (Created)
+ * @date    2026.10.16 (Last Modified)
+ */
+
+#include "bench.h"
+#include "k_messaging.h"
+
+#define RECEIVER_BOX    1
+#define PRODUCERS       16      /// Producers sending to the box. Their box IDs are 0 to 15.
+#define PROBE_SRC       (PRODUCERS-1)   /// Producer the selective receives take messages from.
+
+static const uint32_t depth[] = {10, 100, 1000};    /// Queue depths measured.
+
+static pcb_t receiver = {.id = 1};
+
+/**
+ * @brief   Sends a one byte message to the box.
+ */
+static void Send(pmbox_t src)
+{
+    uint8_t data = (uint8_t)src;
+    pmsg_t msg = {.dst = RECEIVER_BOX, .src = src, .data = &data, .size = 1, .flags = MSG_OWN_KERNEL};
+    size_t retsize;
+
+    k_MsgDeliver(&msg, &retsize);
+}
+
+/**
+ * @brief   Times receives that keep the queue at the same depth.
+ * @param   [in] src: Source the receives take messages from. ANY_BOX for any source.
+ * @return  Average time of a send and receive (in ns).
+ * @details A message is sent before every receive. For selective receives it comes
+ *          from the probed producer, so the queue keeps the same mix of producers.
+ */
+static uint64_t TimeRecv(pmbox_t src)
+{
+    uint8_t data;
+    pmsg_t msg = {.dst = RECEIVER_BOX, .data = &data};
+    size_t retsize;
+    uint64_t start = host_ns();
+    int i;
+
+    for (i = 0; i < BENCH_REPEATS; i++) {
+        Send((src == ANY_BOX) ? i % PRODUCERS : src);
+
+        msg.src = src;
+        msg.size = 1;
+        msg.flags = MSG_OWN_KERNEL;
+        k_MsgFetch(&msg, &retsize);
+    }
+
+    return (host_ns() - start) / BENCH_REPEATS;
+}
+
+/**
+ * @brief   Runs the selective receive benchmark.
+ */
+void bench_select()
+{
+    uint64_t selective, any;
+    uint32_t d, i;
+
+    printf("%-7s %14s %14s\n", "depth", "selective", "any source");
+
+    for (d = 0; d < sizeof(depth)/sizeof(depth[0]) && depth[d] < MSG_MAX; d++) {
+        k_MsgInit();
+        k_MsgBoxBind(RECEIVER_BOX, &receiver);
+        k_MsgBoxSetDepth(RECEIVER_BOX, 0, &receiver);
+
+        for (i = 0; i < depth[d]; i++)  Send(i % PRODUCERS);
+
+        selective = TimeRecv(PROBE_SRC);
+        any = TimeRecv(ANY_BOX);
+
+        printf("%7u %11llu ns %11llu ns\n", depth[d],
+               (unsigned long long)selective, (unsigned long long)any);
+
+        k_MsgBoxUnbind(RECEIVER_BOX, &receiver);
+    }
+}
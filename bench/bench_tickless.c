@@ -0,0 +1,150 @@
+/**
+ * @file    bench_tickless.c
+ * @brief   Counts the SysTick interrupts of the tickless mode against the periodic tick.
+ * @details The suite is built with TICKLESS_MODE set (see the Makefile).
+ *          A workload runs for a simulated second the way SystemTick_handler()
+ *          and PendSV_handler() would run it: on every interrupt the kernel time
+ *          is moved forward, and a process is scheduled when its quantum ran out
+ *          or a timer woke one up. The periodic tick interrupts on every tick,
+ *          the tickless mode only once the SysTick period it programmed runs out.
+ * @author  Manuel Burnay
+ * @date    2026.10.16 (Created)
+ * @date    2026.10.16 (Last Modified)
+ */
+
+#include "bench.h"
+#include "k_processes.h"
+#include "k_scheduler.h"
+#include "k_timer.h"
+#include "systick.h"
+
+#if TICKLESS_MODE
+
+#define DURATION    1000    /// Simulated time a workload runs for (in ticks, 1 s).
+
+/** @brief  Workload structure. */
+typedef struct workload_ {
+    const char* name;   /**< Name the workload is printed with. */
+    uint32_t    busy;   /**< CPU-bound processes, which only give up the CPU when their quantum runs out. */
+    uint32_t    period; /**< Period of a process that sleeps until its next release (in ticks). 0 for none. */
+} workload_t;
+
+static const workload_t workload[] = {
+    {"idle", 0, 0},
+    {"busy", 3, 10},
+    {"1 ms periodic", 0, 1},
+};
+
+extern pcb_t proc_table[PID_MAX];
+extern pcb_t* running;
+extern uint32_t systick_period;
+
+static pcb_t* sleeper = &proc_table[1];
+static uint32_t release;
+
+/**
+ * @brief   Switches to the process Schedule() picks, the way PendSV_handler() does.
+ * @param   [in] w: Workload that runs.
+ * @param   [in] tickless: Whether the SysTick is programmed for the next kernel event.
+ * @details The sleeping process goes back to sleep as soon as it runs.
+ */
+static void Dispatch(const workload_t* w, bool tickless)
+{
+    if (running->state == RUNNING)  running->state = WAITING_TO_RUN;
+    running = Schedule();
+
+    while (running == sleeper) {
+        release += w->period;
+        k_TimerSetup(&sleeper->alarm, &k_TimerWake, sleeper);
+        k_TimerStart(&sleeper->alarm, release - k_GetTime());
+        BlockPCB(sleeper, SLEEPING);
+
+        running = Schedule();
+    }
+
+    running->state = RUNNING;
+    running->timer = GetQuantum(running);
+
+    if (tickless)   k_TickProgram(running->timer);
+}
+
+/**
+ * @brief   Runs a workload for DURATION ticks.
+ * @param   [in] w: Workload to run.
+ * @param   [in] tickless: Whether the SysTick is programmed for the next kernel event.
+ * @return  Amount of SysTick interrupts.
+ */
+static uint32_t Run(const workload_t* w, bool tickless)
+{
+    uint32_t interrupts = 0, ticks, i;
+
+    process_init();
+    scheduler_init();
+    k_TimerInit();
+
+    proc_table[0].state = WAITING_TO_RUN;
+    LinkPCB(&proc_table[0], IDLE_LEVEL);
+
+    if (w->period != 0) {
+        sleeper->base_priority = HIGH_PRIORITY;
+        sleeper->state = WAITING_TO_RUN;
+        LinkPCB(sleeper, HIGH_PRIORITY);
+    }
+
+    for (i = 0; i < w->busy; i++) {
+        proc_table[2+i].base_priority = USER_PRIORITY;
+        proc_table[2+i].state = WAITING_TO_RUN;
+        LinkPCB(&proc_table[2+i], USER_PRIORITY);
+    }
+
+    release = k_GetTime();
+    running = &proc_table[0];
+    Dispatch(w, tickless);
+
+    while (k_GetTime() < DURATION) {
+        ticks = (tickless) ? systick_period / (F_CPU_CLK/TICK_RATE) : 1;
+        interrupts++;
+
+        running->timer -= ticks;
+
+        if (k_TimeAdvance(ticks) || running->timer <= 0)    Dispatch(w, tickless);
+        else if (tickless)  k_TickProgram(running->timer);
+    }
+
+    for (i = 0; i < PID_MAX; i++) {
+        if (proc_table[i].state == WAITING_TO_RUN || proc_table[i].state == RUNNING) {
+            UnlinkPCB(&proc_table[i]);
+        }
+    }
+
+    return interrupts;
+}
+
+/**
+ * @brief   Runs the tickless benchmark.
+ */
+void bench_tickless()
+{
+    uint32_t w, periodic, tickless;
+
+    printf("%-14s %10s %10s\n", "workload", "periodic", "tickless");
+
+    for (w = 0; w < sizeof(workload)/sizeof(workload[0]); w++) {
+        periodic = Run(&workload[w], false);
+        tickless = Run(&workload[w], true);
+
+        printf("%-14s %10u %10u\n", workload[w].name, periodic, tickless);
+    }
+}
+
+#else
+
+/**
+ * @brief   Runs the tickless benchmark.
+ */
+void bench_tickless()
+{
+    printf("Needs TICKLESS_MODE, run build/tickless/bench tickless\n");
+}
+
+#endif
@@ -0,0 +1,93 @@
+/**
+ * @file    bench_timer.c
+ * @brief   Benchmarks the timing wheel against the amount of armed timers.
+ * @details Arming, cancelling and expiring a timer should cost the same
+ *          with 10 or 10,000 timers armed.
+ * @author  Manuel Burnay
+ * @date    2026.10.16 (Created)
+ * @date    2026.10.16 (Last Modified)
+ */
+
+#include "bench.h"
+#include "k_timer.h"
+
+#define TIMERS_MAX      10000   /// Most timers armed at once.
+#define DELAY_MAX       60000   /// Longest delay a timer is armed for (in ticks).
+#define TIMER_TICKS     100000  /// Ticks the wheel is moved forward for, one by one.
+#define TIMER_EXPIRIES  20000   /// Rough amount of expiries timed per amount of armed timers.
+
+static const uint32_t armed[] = {10, 100, 1000, 10000};  /// Amounts of armed timers measured.
+
+static ktimer_t timers[TIMERS_MAX];
+static uint32_t seed;
+static uint32_t expired;
+
+/**
+ * @brief   Gets a pseudo-random timer delay.
+ * @return  Delay between 1 and DELAY_MAX ticks.
+ */
+static uint32_t Delay()
+{
+    seed = seed*1664525 + 1013904223;
+    return 1 + (seed >> 8) % DELAY_MAX;
+}
+
+/**
+ * @brief   Re-arms an expired timer, so the amount of armed timers stays the same.
+ */
+static void Rearm(ktimer_t* tmr)
+{
+    expired++;
+    k_TimerStart(tmr, Delay());
+}
+
+/**
+ * @brief   Runs the timing wheel benchmark.
+ * @details Timers are armed with random delays spread over the whole wheel.
+ *          The probe timer is armed and cancelled among them, and then the wheel
+ *          is moved forward tick by tick while expired timers are re-armed.
+ *          Expiries are timed by moving the wheel from one expiry to the next
+ *          (like the tickless mode does), long enough for about the same amount
+ *          of expiries with any amount of armed timers.
+ *          A tick only costs more with more timers armed because more of them
+ *          expire on every tick.
+ */
+void bench_timer()
+{
+    ktimer_t probe;
+    uint64_t start, arm, tick, expiry;
+    uint32_t a, i;
+
+    printf("%-8s %14s %12s %14s\n", "armed", "start/cancel", "tick", "expiry");
+
+    for (a = 0; a < sizeof(armed)/sizeof(armed[0]); a++) {
+        seed = 1;
+
+        k_TimerInit();
+        k_TimerSetup(&probe, &Rearm, NULL);
+
+        for (i = 0; i < armed[a]; i++) {
+            k_TimerSetup(&timers[i], &Rearm, NULL);
+            k_TimerStart(&timers[i], Delay());
+        }
+
+        start = host_ns();
+        for (i = 0; i < BENCH_REPEATS; i++) {
+            k_TimerStart(&probe, Delay());
+            k_TimerCancel(&probe);
+        }
+        arm = (host_ns() - start) / BENCH_REPEATS;
+
+        start = host_ns();
+        for (i = 0; i < TIMER_TICKS; i++)   k_WheelTick();
+        tick = (host_ns() - start) / TIMER_TICKS;
+
+        expired = 0;
+        start = host_ns();
+        k_TimeAdvance((uint64_t)TIMER_EXPIRIES * (DELAY_MAX/2) / armed[a]);
+        expiry = (expired != 0) ? (host_ns() - start) / expired : 0;
+
+        printf("%8u %11llu ns %9llu ns %11llu ns\n", armed[a], (unsigned long long)arm,
+               (unsigned long long)tick, (unsigned long long)expiry);
+    }
+}
@@ -0,0 +1,50 @@
+/**
+ * @file    host.c
+ * @brief   Contains the host services used by the benchmarks.
+ * @details This is the only file built against the host's own C library headers.
+ *          The kernel's sources are built against the headers in include/,
+ *          since the kernel's types clash with the host's (e.g. pid_t).
+ * @author  Manuel Burnay
+ * @date    2026.10.16 (Created)
+ * @date    2026.10.16 (Last Modified)
+ */
+
+#define _GNU_SOURCE
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <sys/mman.h>
+
+#define PPB_PAGE    ((void*)0xE000E000) /// Page of the Cortex-M's private peripherals (NVIC, SysTick).
+#define PPB_SIZE    0x1000
+
+/**
+ * @brief   Gets the host's monotonic time.
+ * @return  Time in nanoseconds.
+ */
+uint64_t host_ns()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t)ts.tv_sec*1000000000u + ts.tv_nsec;
+}
+
+/**
+ * @brief   Maps plain memory where the target's private peripherals are.
+ * @details The kernel triggers PendSV by writing the NVIC's register directly,
+ *          so that write needs somewhere harmless to land on the host.
+ */
+void host_map_ppb()
+{
+    void* page = mmap(PPB_PAGE, PPB_SIZE, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+
+    if (page != PPB_PAGE) {
+        perror("host_map_ppb");
+        exit(1);
+    }
+}
@@ -0,0 +1,13 @@
+/**
+ * @file    stdio.h
+ * @brief   Declares the parts of the host's stdio.h the kernel sources use.
+ */
+
+#ifndef BENCH_STDIO_H
+#define BENCH_STDIO_H
+
+#include <stddef.h>
+
+int printf(const char* format, ...);
+
+#endif  // BENCH_STDIO_H
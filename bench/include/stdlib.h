@@ -0,0 +1,15 @@
+/**
+ * @file    stdlib.h
+ * @brief   Declares the parts of the host's stdlib.h the kernel sources use.
+ */
+
+#ifndef BENCH_STDLIB_H
+#define BENCH_STDLIB_H
+
+#include <stddef.h>
+
+void* malloc(size_t size);
+void free(void* ptr);
+int atoi(const char* str);
+
+#endif  // BENCH_STDLIB_H
@@ -0,0 +1,17 @@
+/**
+ * @file    string.h
+ * @brief   Declares the parts of the host's string.h the kernel sources use.
+ */
+
+#ifndef BENCH_STRING_H
+#define BENCH_STRING_H
+
+#include <stddef.h>
+
+void* memcpy(void* dst, const void* src, size_t n);
+void* memset(void* dst, int c, size_t n);
+size_t strlen(const char* str);
+char* strcpy(char* dst, const char* src);
+int strcmp(const char* a, const char* b);
+
+#endif  // BENCH_STRING_H
@@ -0,0 +1,25 @@
+/**
+ * @file    stubs.c
+ * @brief   Contains the target-only kernel functions, stubbed out for the host.
+ * @details The benchmarks drive the kernel's data structures directly,
+ *          so no process ever runs and the SysTick is never programmed.
+ * @author  Manuel Burnay
+ * @date    2026.10.16 (Created)
+ * @date    2026.10.16 (Last Modified)
+ */
+
+#include "k_cpu.h"
+#include "systick.h"
+
+pcb_t* running;     /// Process the kernel calls are made for. Set by the benchmarks.
+uint32_t systick_period;    /// Clock cycles the SysTick was last programmed for one-shot.
+
+inline void InitProcessContext(uint32_t** sp, void (*proc_program)(), void (*exit_program)(), void* arg) {}
+
+void SysTick_Init(uint32_t Period) {}
+void SysTick_SetPeriod(uint32_t Period) {}
+void SysTick_Reset(void) {}
+void SysTick_OneShot(uint32_t Period) { systick_period = Period; }
+uint32_t SysTick_Elapsed(void) { return 0; }
+bool SysTick_Expired(void) { return false; }
+bool SysTick_Pending(void) { return false; }
@@ -3,12 +3,13 @@
  * @brief   Contains all the kernel call functions that user programs have access to.
  * @author  Manuel Burnay
  * @date    2019.10.23 (Created)
- * @date    2019.11.29 (Last Modified)
+ * @date    2026.10.16 (Last Modified)
  */
 
 #include <stdlib.h>
 #include <string.h>
 #include "k_cpu.h"
+#include "cpu.h"
 #include "calls.h"
 
 /**
@@ -39,6 +40,57 @@ pid_t pcreate(process_attr_t* attr, void (*proc_program)())
     return (pid_t)kcall(PCREATE, (k_arg_t)&args);
 }
 
+/**
+ * @brief   Requests the creation of a periodic process.
+ * @param   [in] attr: Pointer to process attributes. Can be NULL.
+ *                     The period and wcet passed here take precedence over attr's.
+ * @param   [in] period: Release period of the process (in ms).
+ * @param   [in] wcet: Worst-case execution time of a job (in ms).
+ * @param   [in] job: Function run on every release, with attr's argument.
+ * @return  Process ID of the created process.
+ *          PROC_ERR if the process failed to be allocated or
+ *          would make the periodic processes unschedulable.
+ * @details Unless attr asks for a fixed user priority, the process runs
+ *          in the EDF band with its period as deadline (if none is given).
+ */
+pid_t pcreate_periodic(process_attr_t* attr, uint32_t period, uint32_t wcet,
+                       void (*job)(void*))
+{
+    process_attr_t pattr = {.id = 0, .priority = 0, .name = ""};
+
+    if (attr != NULL)   pattr = *attr;
+
+    pattr.period = period;
+    pattr.wcet = wcet;
+
+    pcreate_args_t args = {.attr = &pattr, .proc_program = &periodic_process, .job = job};
+    return (pid_t)kcall(PCREATE, (k_arg_t)&args);
+}
+
+/**
+ * @brief   Program run by periodic processes.
+ * @param   [in] arg: Process argument, passed on to the job.
+ * @param   [in] job: Function run on every release.
+ */
+void periodic_process(void* arg, void (*job)(void*))
+{
+    while (1) {
+        job(arg);
+        wait_period();
+    }
+}
+
+/**
+ * @brief   Ends the running job of a periodic process.
+ * @details This is a preemptive call. The process sleeps until its next
+ *          release. If that release has already passed, the next job
+ *          starts right away.
+ */
+void wait_period(void)
+{
+    kcall(WAIT_PERIOD, NULL);
+}
+
 /**
  * @brief   Requests the termination of the running process.
  */
@@ -107,6 +159,49 @@ pmbox_t getbox()
     return (pmbox_t)kcall(GETBOX, NULL);
 }
 
+/**
+ * @brief   Binds a message box to the running process as a topic.
+ * @param   [in] topic: Box ID to bind with. ANY_BOX for any available box.
+ * @return  The box ID of the topic.
+ *          BOX_ERR if the box couldn't be bound.
+ * @details Messages sent to a topic are published to all boxes subscribed to it.
+ *          The message is stored once, however many subscribers queue it.
+ *          The topic is unbound like any other box.
+ */
+pmbox_t bind_topic(pmbox_t topic)
+{
+    return (pmbox_t)kcall(TOPIC_BIND, (k_arg_t)&topic);
+}
+
+/**
+ * @brief   Subscribes a message box to a topic.
+ * @param   [in] topic: Box ID of the topic.
+ * @param   [in] box: Box of the running process to receive the topic's messages on.
+ * @return  True if the box was subscribed,
+ *          False otherwise.
+ */
+bool subscribe(pmbox_t topic, pmbox_t box)
+{
+    subscribe_args_t args = {.topic = topic, .box = box};
+
+    return (bool)kcall(SUBSCRIBE, (k_arg_t)&args);
+}
+
+/**
+ * @brief   Unsubscribes a message box from a topic.
+ * @param   [in] topic: Box ID of the topic.
+ * @param   [in] box: Box of the running process subscribed to the topic.
+ * @return  True if the box was unsubscribed,
+ *          False if it wasn't subscribed.
+ * @details Messages already queued on the box are kept.
+ */
+bool unsubscribe(pmbox_t topic, pmbox_t box)
+{
+    subscribe_args_t args = {.topic = topic, .box = box};
+
+    return (bool)kcall(UNSUBSCRIBE, (k_arg_t)&args);
+}
+
 /**
  * @brief   Send a message to a process.
  * @param   [in] dst: Destination message box for the message.
@@ -117,6 +212,10 @@ pmbox_t getbox()
  *          This does not guarantee that all bytes will be received however,
  *          as message can be placed on hold until the receiver asks for a message,
  *          and cannot take all the contents of the message.
+ * @details This is a preemptive call. If the destination box' queue is full,
+ *          the process blocks until the receiver takes a message out.
+ *          Blocked senders get in in the order they blocked.
+ *          A send to a full box the running process owns returns MSG_AGAIN.
  */
 size_t send(pmbox_t dst, pmbox_t src, uint8_t* data, uint32_t size)
 {
@@ -125,6 +224,58 @@ size_t send(pmbox_t dst, pmbox_t src, uint8_t* data, uint32_t size)
     return (size_t)kcall(SEND, (k_arg_t)&msg);
 }
 
+/**
+ * @brief   Send a message to a process, without blocking.
+ * @param   [in] dst: Destination message box for the message.
+ * @param   [in] src: Source message box for the message.
+ * @param   [in] data: Message data to be sent.
+ * @param   [in] size: Size of the message data.
+ * @return  Amount of bytes able to send to destination,
+ *          MSG_AGAIN if the destination box' queue is full.
+ */
+size_t try_send(pmbox_t dst, pmbox_t src, uint8_t* data, uint32_t size)
+{
+    pmsg_t msg = {.dst = dst, .src = src, .data = data, .size = size};
+
+    return (size_t)kcall(TRY_SEND, (k_arg_t)&msg);
+}
+
+/**
+ * @brief   Sets the limit of messages queued on a message box.
+ * @param   [in] box: Message box bound to the running process.
+ * @param   [in] depth: Most messages the box queues. 0 for no limit.
+ * @return  True if the limit was set,
+ *          False if the box isn't bound to the running process.
+ * @details Boxes are bound with a limit of MSGBOX_DEPTH.
+ *          Replies a request waits on, a client's only unanswered request
+ *          and messages sent by the kernel aren't held back by the limit.
+ */
+bool set_depth(pmbox_t box, uint32_t depth)
+{
+    box_depth_args_t args = {.box = box, .depth = depth};
+
+    return (bool)kcall(SET_DEPTH, (k_arg_t)&args);
+}
+
+/**
+ * @brief   Send a message to a process, with a priority.
+ * @param   [in] dst: Destination message box for the message.
+ * @param   [in] src: Source message box for the message.
+ * @param   [in] data: Message data to be sent.
+ * @param   [in] size: Size of the message data.
+ * @param   [in] prio: Message priority, up to MSG_PRIORITIES-1.
+ *                     Regular messages have priority 0.
+ * @return  Amount of bytes able to send to destination.
+ * @details The message is received ahead of all queued messages
+ *          of a lower priority, so it doesn't wait behind a backlog.
+ */
+size_t send_prio(pmbox_t dst, pmbox_t src, uint8_t* data, uint32_t size, uint8_t prio)
+{
+    pmsg_t msg = {.dst = dst, .src = src, .data = data, .size = size, .prio = prio};
+
+    return (size_t)kcall(SEND, (k_arg_t)&msg);
+}
+
 /**
  * @brief   Recieves a message from a process.
  * @param   [in] dst: Destination message box for the message.
@@ -149,6 +300,85 @@ size_t recv(pmbox_t dst, pmbox_t src, uint8_t* data, uint32_t size, pmbox_t* src
     return retval;
 }
 
+/**
+ * @brief   Recieves a message from a process, without blocking.
+ * @param   [in] dst: Destination message box for the message.
+ * @param   [in] src: Source message box for the message.
+ * @param   [out] data: Pointer to location where message data will be sent to.
+ * @param   [in] size: Maximum message size supported.
+ * @param   [out] src_ret:
+ *              If not NULL, the mailbox src ID that
+ *              sent the message received will be copied here.
+ * @return  Amount of bytes received,
+ *          MSG_EMPTY if no message was queued.
+ */
+size_t try_recv(pmbox_t dst, pmbox_t src, uint8_t* data, uint32_t size, pmbox_t* src_ret)
+{
+    pmsg_t msg = {.dst = dst, .src = src, .data = data, .size = size};
+
+    size_t retval = kcall(TRY_RECV, (k_arg_t)&msg);
+
+    if (src_ret != NULL && retval != MSG_EMPTY) *src_ret = msg.src;
+
+    return retval;
+}
+
+/**
+ * @brief   Sends a message asynchronously, with a completion notification.
+ * @param   [in] dst: Destination message box for the message.
+ * @param   [in] src: Source message box for the message.
+ * @param   [in] data: Message data to be sent.
+ *                     Has to stay untouched until the completion record arrives.
+ * @param   [in] size: Size of the message data. Has to be at least 1.
+ * @param   [in] notify: Box of the running process the completion record
+ *                       (async_done_t) is posted to.
+ * @param   [in] tag: Tag copied into the completion record.
+ * @return  True if the send was taken in,
+ *          False if the arguments aren't valid or too many sends are in flight.
+ * @details Never blocks. If the kernel is out of message buffers, the send
+ *          is held and completed as buffers are freed. The completion record
+ *          holds the amount of bytes sent.
+ */
+bool send_async(pmbox_t dst, pmbox_t src, uint8_t* data, uint32_t size,
+                pmbox_t notify, uint32_t tag)
+{
+    pmsg_t msg = {.dst = dst, .src = src, .data = data, .size = size};
+
+    send_async_args_t args = {.msg = &msg, .notify = notify, .tag = tag};
+
+    return (bool)kcall(SEND_ASYNC, (k_arg_t)&args);
+}
+
+/**
+ * @brief   Recieves a message from any box of a set.
+ * @param   [in] box_set: Bitmap of the boxes to receive from.
+ *                        All of them have to be bound to the running process.
+ * @param   [out] data: Pointer to location where message data will be sent to.
+ * @param   [in] size: Maximum message size supported.
+ * @param   [out] box_ret: If not NULL, the box the message came in on is copied here.
+ * @param   [out] src_ret:
+ *              If not NULL, the mailbox src ID that
+ *              sent the message received will be copied here.
+ * @return  Amount of bytes received.
+ * @details This is a preemptive call. If no box has a message queued,
+ *          the process blocks until a message arrives on any of them.
+ *          Queued messages are taken from the lowest box ID first.
+ */
+size_t recv_any(bitmap_t* box_set, uint8_t* data, uint32_t size,
+                pmbox_t* box_ret, pmbox_t* src_ret)
+{
+    pmsg_t msg = {.dst = ANY_BOX, .src = ANY_BOX, .data = data, .size = size};
+
+    recv_any_args_t args = {.set = box_set, .msg = &msg};
+
+    size_t retval = kcall(RECV_ANY, (k_arg_t)&args);
+
+    if (box_ret != NULL)    *box_ret = msg.dst;
+    if (src_ret != NULL)    *src_ret = msg.src;
+
+    return retval;
+}
+
 /**
  * @brief   Performs a request transaction to a process.
  * @param   [in] dst: Message box to perform the request transaction.
@@ -159,7 +389,9 @@ size_t recv(pmbox_t dst, pmbox_t src, uint8_t* data, uint32_t size, pmbox_t* src
  * @param   [in] req_size: Size of the request message data.
  * @param   [out] ret: Pointer to location where reply message data will be sent to.
  * @param   [in] ret_max: Maximum size allowed for the reply message data.
- * @param   Number of bytes received by the return message.
+ * @param   Number of bytes received by the return message,
+ *          MSG_AGAIN if an earlier request from src to dst is still unanswered
+ *          and the dst box' queue is full.
  * @details A request transation simply consists of
  *          a send+recv to a particular process. This call simply does it both in
  *          kernel space to improve performance, as it is a common interaction
@@ -176,6 +408,288 @@ size_t request(pmbox_t dst, pmbox_t src,
     return kcall(REQUEST, (k_arg_t)&args);
 }
 
+/**
+ * @brief   Starts a request transaction without waiting on its reply.
+ * @param   [in] dst: Message box to perform the request transaction.
+ * @param   [in] src: Source message box the reply will be sent to.
+ * @param   [in] req: Request message data to be sent.
+ * @param   [in] req_size: Size of the request message data.
+ * @return  Ticket of the request, to wait on its reply with.
+ *          TICKET_NONE if the request couldn't be sent
+ *          (e.g. the dst box' queue is full).
+ * @details Several requests can be outstanding from the same box,
+ *          each reply is matched to its request by ticket.
+ *          Servers don't need to be aware of tickets: the next message
+ *          a server sends back to the client box is the reply to the
+ *          oldest unanswered request it got from it.
+ */
+uint32_t request_async(pmbox_t dst, pmbox_t src, uint8_t* req, size_t req_size)
+{
+    pmsg_t msg = {.dst = dst, .src = src, .data = req, .size = req_size};
+
+    return (uint32_t)kcall(REQUEST_ASYNC, (k_arg_t)&msg);
+}
+
+/**
+ * @brief   Waits on the reply to an asynchronous request.
+ * @param   [in] ticket: Ticket returned by request_async.
+ * @param   [out] ret: Pointer to location where reply message data will be sent to.
+ * @param   [in] ret_max: Maximum size allowed for the reply message data.
+ * @return  Number of bytes received by the reply message,
+ *          MSG_EMPTY if the ticket isn't an outstanding request of the process.
+ * @details This is a preemptive call. The ticket is no longer valid afterwards.
+ */
+size_t wait_reply(uint32_t ticket, uint8_t* ret, size_t ret_max)
+{
+    pmsg_t msg = {.dst = ANY_BOX, .src = ANY_BOX, .data = ret, .size = ret_max};
+
+    wait_reply_args_t args = {.ticket = ticket, .msg = &msg};
+
+    return kcall(WAIT_REPLY, (k_arg_t)&args);
+}
+
+/**
+ * @brief   Waits on the reply to any outstanding asynchronous request.
+ * @param   [out] ret: Pointer to location where reply message data will be sent to.
+ * @param   [in] ret_max: Maximum size allowed for the reply message data.
+ * @param   [out] ticket_ret: If not NULL, the ticket of the reply is copied here.
+ * @return  Number of bytes received by the reply message,
+ *          MSG_EMPTY if the process has no outstanding request.
+ * @details This is a preemptive call. Replies that already arrived
+ *          are returned oldest request first.
+ */
+size_t wait_any_reply(uint8_t* ret, size_t ret_max, uint32_t* ticket_ret)
+{
+    pmsg_t msg = {.dst = ANY_BOX, .src = ANY_BOX, .data = ret, .size = ret_max};
+
+    wait_reply_args_t args = {.ticket = TICKET_ANY, .msg = &msg};
+
+    size_t retval = kcall(WAIT_REPLY, (k_arg_t)&args);
+
+    if (ticket_ret != NULL && retval != MSG_EMPTY)  *ticket_ret = msg.corr;
+
+    return retval;
+}
+
+/**
+ * @brief   Sends a batch of messages in a single kernel call.
+ * @param   [in,out] msgs: Messages to send. Each message's size is overwritten
+ *                         with the amount of bytes sent to its destination,
+ *                         or MSG_AGAIN if the destination box was full.
+ * @param   [in] count: Amount of messages to send.
+ * @return  Amount of messages sent.
+ * @details This is a preemptive call. Messages are sent in order and
+ *          the scheduler runs once, after all of them were sent.
+ *          The call never blocks on a full box.
+ */
+uint32_t send_many(msg_vec_t* msgs, uint32_t count)
+{
+    send_many_args_t args = {.msgs = msgs, .count = count};
+
+    return (uint32_t)kcall(SEND_MANY, (k_arg_t)&args);
+}
+
+/**
+ * @brief   Receives a batch of queued messages in a single kernel call.
+ * @param   [in] dst: Message box to receive the messages from.
+ * @param   [in] src: Source message box of the messages. ANY_BOX for any source.
+ * @param   [out] buf: Buffer the messages are copied into, one after the other.
+ * @param   [in] max: Size of the buffer.
+ * @param   [out] msgs: Array where every received message is described,
+ *                      with data pointing to its place in buf.
+ * @param   [in] count: Maximum amount of messages to receive.
+ * @return  Amount of messages received.
+ * @details This is a preemptive call. Queued messages are received until
+ *          count is reached or the next one doesn't fit in buf.
+ *          The first message is truncated if it doesn't fit on its own.
+ *          If no messages are queued the process blocks until one arrives,
+ *          and only that one is received.
+ */
+uint32_t recv_many(pmbox_t dst, pmbox_t src, uint8_t* buf, size_t max,
+                   msg_vec_t* msgs, uint32_t count)
+{
+    recv_many_args_t args = {
+         .msg = {.dst = dst, .src = src, .data = buf, .size = max},
+         .msgs = msgs,
+         .count = count,
+         .blocked = false
+    };
+
+    uint32_t retval = (uint32_t)kcall(RECV_MANY, (k_arg_t)&args);
+
+    if (args.blocked) {
+        msgs[0].dst = dst;
+        msgs[0].src = args.msg.src;
+        msgs[0].data = buf;
+        msgs[0].size = args.first;
+    }
+
+    return retval;
+}
+
+/**
+ * @brief   Borrows a kernel message buffer to write a message in place.
+ * @param   [in] size: Size of the message that will be written (up to MSG_MAX_SIZE).
+ * @return  Pointer to the loaned buffer,
+ *          NULL if no buffer is available.
+ * @details The buffer is handed over to the kernel by send_loaned,
+ *          or given back with msg_release.
+ */
+uint8_t* msg_loan(size_t size)
+{
+    return (uint8_t*)kcall(MSG_LOAN, (k_arg_t)&size);
+}
+
+/**
+ * @brief   Sends a message written in a loaned buffer, without copying it.
+ * @param   [in] dst: Destination message box for the message.
+ * @param   [in] src: Source message box for the message.
+ * @param   [in] buf: Buffer returned by msg_loan.
+ * @param   [in] size: Size of the message (up to the size it was loaned for).
+ * @return  Amount of bytes sent.
+ *          0 if the message couldn't be sent, in which case the buffer
+ *          is still loaned to the process.
+ * @details The process must not touch the buffer after a successful send.
+ */
+size_t send_loaned(pmbox_t dst, pmbox_t src, uint8_t* buf, size_t size)
+{
+    pmsg_t msg = {.dst = dst, .src = src, .data = buf, .size = size};
+
+    return (size_t)kcall(SEND_LOANED, (k_arg_t)&msg);
+}
+
+/**
+ * @brief   Recieves a message by borrowing its kernel buffer, without copying it.
+ * @param   [in] dst: Destination message box for the message.
+ * @param   [in] src: Source message box for the message.
+ * @param   [out] data: Pointer to the borrowed message buffer is placed here.
+ * @param   [out] src_ret:
+ *              If not NULL, the mailbox src ID that
+ *              sent the message received will be copied here.
+ * @return  Amount of bytes received.
+ * @details This is a preemptive call. The borrowed buffer must be given back
+ *          with msg_release once the process is done with it.
+ */
+size_t recv_loaned(pmbox_t dst, pmbox_t src, uint8_t** data, pmbox_t* src_ret)
+{
+    pmsg_t msg = {.dst = dst, .src = src, .data = NULL, .size = 0};
+
+    size_t retval = kcall(RECV_LOANED, (k_arg_t)&msg);
+
+    if (data != NULL)       *data = msg.data;
+    if (src_ret != NULL)    *src_ret = msg.src;
+
+    return retval;
+}
+
+/**
+ * @brief   Gives a loaned or borrowed message buffer back to the kernel.
+ * @param   [in] buf: Buffer returned by msg_loan or recv_loaned.
+ * @return  True if the buffer was released,
+ *          False if it isn't held by the process.
+ */
+bool msg_release(uint8_t* buf)
+{
+    return (bool)kcall(MSG_RELEASE, (k_arg_t)buf);
+}
+
+/**
+ * @brief   Replies to a client and waits for the next request, in a single call.
+ * @param   [in] box: Server's message box. Replies are sent from it
+ *                    and requests are received on it.
+ * @param   [in] dst: Client box to reply to.
+ *                    BOXID_MAX (or above) to only wait for a request.
+ * @param   [in] reply: Reply message data.
+ * @param   [in] reply_size: Size of the reply message data.
+ * @param   [out] buf: Pointer to location where the next request will be sent to.
+ * @param   [in] max: Maximum request size supported.
+ * @param   [out] src_ret: If not NULL, the box the request came from is copied here.
+ * @return  Amount of bytes received on the next request.
+ * @details This is a preemptive call meant for server loops.
+ *          A client blocked on a request gets the reply copied straight
+ *          into its reply buffer, and the kernel can switch straight back to it.
+ *          A reply no request is waiting on is dropped if the dst box' queue is full.
+ */
+size_t reply_wait(pmbox_t box, pmbox_t dst, uint8_t* reply, size_t reply_size,
+                  uint8_t* buf, size_t max, pmbox_t* src_ret)
+{
+    pmsg_t reply_msg = {.dst = dst, .src = box, .data = reply, .size = reply_size};
+    pmsg_t recv_msg = {.dst = box, .src = ANY_BOX, .data = buf, .size = max};
+
+    reply_wait_args_t args = {.reply = &reply_msg, .recv = &recv_msg};
+
+    size_t retval = kcall(REPLY_WAIT, (k_arg_t)&args);
+
+    if (src_ret != NULL)    *src_ret = recv_msg.src;
+
+    return retval;
+}
+
+/**
+ * @brief   Recieves a message from a process, waiting for a limited amount of time.
+ * @param   [in] dst: Destination message box for the message.
+ * @param   [in] src: Source message box for the message.
+ * @param   [out] data: Pointer to location where message data will be sent to.
+ * @param   [in] size: Maximum message size supported.
+ * @param   [out] src_ret:
+ *              If not NULL, the mailbox src ID that
+ *              sent the message received will be copied here.
+ * @param   [in] ms: Maximum time to wait for a message (in ms). At least 1 ms is waited.
+ * @return  Amount of bytes received,
+ *          MSG_TIMEOUT if no message arrived in time.
+ * @details This is a preemptive call. The process will block if no messages can
+ *          be received at the time of the kernel call, until one arrives
+ *          or the time runs out.
+ */
+size_t recv_timeout(pmbox_t dst, pmbox_t src, uint8_t* data, uint32_t size,
+                    pmbox_t* src_ret, uint32_t ms)
+{
+    pmsg_t msg = {.dst = dst, .src = src, .data = data, .size = size};
+
+    recv_timeout_args_t args = {.msg = &msg, .ms = ms};
+
+    size_t retval = kcall(RECV_TIMEOUT, (k_arg_t)&args);
+
+    if (src_ret != NULL && retval != MSG_TIMEOUT)   *src_ret = msg.src;
+
+    return retval;
+}
+
+/**
+ * @brief   Performs a request transaction to a process,
+ *          waiting for the reply for a limited amount of time.
+ * @param   [in] dst: Message box to perform the request transaction.
+ * @param   [in] src:
+ *                  Source message box where the
+ *                  request transaction will be engaged from.
+ * @param   [in] req: Request message data to be sent.
+ * @param   [out] ret: Pointer to location where reply message data will be sent to.
+ * @param   [in] req_size: Size of the request message data.
+ * @param   [in] ret_max: Maximum size allowed for the reply message data.
+ * @param   [in] ms: Maximum time to wait for the reply (in ms).
+ * @return  Number of bytes received by the return message,
+ *          MSG_TIMEOUT if no reply arrived in time,
+ *          MSG_AGAIN if an earlier request from src to dst is still unanswered
+ *          and the dst box' queue is full.
+ * @details A reply that arrives after the timeout is discarded,
+ *          so it isn't mistaken for the reply to a later request.
+ *          Servers have to reply to their requests in order for this to hold.
+ */
+size_t request_timeout(pmbox_t dst, pmbox_t src,
+                       uint8_t* req, size_t req_size, uint8_t* ret, size_t ret_max,
+                       uint32_t ms)
+{
+    pmsg_t req_msg = {.dst = dst, .src = src, .data = req, .size = req_size};
+    pmsg_t ret_msg = {.dst = src, .src = dst, .data = ret, .size = ret_max};
+
+    request_timeout_args_t args = {
+         .req = {.req_msg = &req_msg, .ret_msg = &ret_msg},
+         .ms = ms
+    };
+
+    return kcall(REQUEST_TIMEOUT, (k_arg_t)&args);
+}
+
 /**
  * @brief   Send a character string to IO server to be displayed to user.
  * @param   [in] box: Box ID where user data will be sent from.
@@ -254,5 +768,166 @@ void set_name(char* src_str)
     kcall(SET_NAME, (k_arg_t)src_str);
 }
 
+/**
+ * @brief   Sets the time quantum of the running process.
+ * @param   [in] ms:
+ *              New time quantum in ms.
+ *              0 makes the process use the default quantum of its priority level.
+ * @return  The quantum the process will run with.
+ * @details The new quantum takes effect from the process' next time slice.
+ */
+uint32_t quantum(uint32_t ms)
+{
+    return (uint32_t)kcall(QUANTUM, (k_arg_t)&ms);
+}
+
+/**
+ * @brief   Puts the running process to sleep.
+ * @param   [in] ms: Amount of time to sleep for (in ms).
+ * @details This is a preemptive call. The process is blocked until the time
+ *          has passed, so it doesn't use any CPU while it waits.
+ */
+void sleep(uint32_t ms)
+{
+    kcall(SLEEP, (k_arg_t)&ms);
+}
+
+/**
+ * @brief   Puts the running process to sleep until an absolute kernel time.
+ * @param   [in] tick: Kernel time (as returned by get_time) to wake up at.
+ * @details This is a preemptive call. Returns right away if the time has passed.
+ *          Periodic processes should advance their wake-up time by their period
+ *          and call this, so their releases don't drift.
+ */
+void sleep_until(uint32_t tick)
+{
+    kcall(SLEEP_UNTIL, (k_arg_t)&tick);
+}
+
+/**
+ * @brief   Gets the kernel time.
+ * @return  Amount of ticks (ms) elapsed since the kernel started.
+ */
+uint32_t get_time(void)
+{
+    return (uint32_t)kcall(GET_TIME, NULL);
+}
+
+/**
+ * @brief   Arms a timer that notifies a message box when it expires.
+ * @param   [in] box: Message box to notify. Must be owned by the process.
+ * @param   [in] ms: Time until the timer expires (in ms).
+ * @param   [in] period: Time between re-arms (in ms). 0 for a one-shot timer.
+ * @return  ID of the armed timer,
+ *          TIMER_ERR if the timer couldn't be armed.
+ * @details Every time the timer expires, a message containing the timer ID
+ *          is sent to the box, using the box itself as the source.
+ *          One-shot timers are released once they expire.
+ */
+id_t settimer(pmbox_t box, uint32_t ms, uint32_t period)
+{
+    settimer_args_t args = {.box = box, .ms = ms, .period = period};
+
+    return (id_t)kcall(SET_TIMER, (k_arg_t)&args);
+}
+
+/**
+ * @brief   Disarms and releases a timer armed by the process.
+ * @param   [in] id: ID of the timer to cancel.
+ * @return  True if the timer was cancelled,
+ *          False if it doesn't exist or belongs to another process.
+ */
+bool canceltimer(id_t id)
+{
+    return (bool)kcall(CANCEL_TIMER, (k_arg_t)&id);
+}
+
+/**
+ * @brief   Creates a single-producer/single-consumer channel.
+ * @param   [in] item_size: Size of the items sent through the channel (in Bytes).
+ * @return  Pointer to the channel, with the running process as its consumer.
+ *          NULL if no channel could be created.
+ * @details The channel's ID (chan->id) is passed on to the producer process,
+ *          which attaches to it with chan_attach.
+ */
+spsc_ring_t* chan_create(uint32_t item_size)
+{
+    return (spsc_ring_t*)kcall(CHAN_CREATE, (k_arg_t)&item_size);
+}
+
+/**
+ * @brief   Attaches the running process to a channel as its producer.
+ * @param   [in] id: Channel ID.
+ * @return  Pointer to the channel,
+ *          NULL if the channel doesn't exist or already has a producer.
+ */
+spsc_ring_t* chan_attach(id_t id)
+{
+    return (spsc_ring_t*)kcall(CHAN_ATTACH, (k_arg_t)&id);
+}
+
+/**
+ * @brief   Sends an item through a channel. Only called by the producer.
+ * @param   [in,out] chan: Pointer to the channel.
+ * @param   [in] item: Item to send. Has to be the channel's item size.
+ * @return  True if the item was sent,
+ *          False if the channel is full, or closed by its consumer
+ *          (chan->closed is set then, and the producer should close its end).
+ * @details Doesn't enter the kernel unless the consumer is waiting for an item.
+ */
+bool chan_send(spsc_ring_t* chan, const void* item)
+{
+    if (!spsc_push(chan, item)) return false;
+
+    // The push has to be visible before the waiting flag is read
+    DMB();
+
+    if (chan->waiting)  kcall(CHAN_NOTIFY, (k_arg_t)&chan->id);
+
+    return true;
+}
+
+/**
+ * @brief   Receives an item from a channel. Only called by the consumer.
+ * @param   [in,out] chan: Pointer to the channel.
+ * @param   [out] item: Where the item is copied to.
+ * @return  True if an item was received,
+ *          False if the producer closed its end and the channel is drained.
+ * @details This is a preemptive call. Doesn't enter the kernel unless
+ *          the channel is empty, in which case the process sleeps
+ *          until the producer sends an item or closes its end.
+ */
+bool chan_recv(spsc_ring_t* chan, void* item)
+{
+    bool open = true;
+
+    while (!spsc_pop(chan, item)) {
+        if (!open)  return false;
+
+        chan->waiting = true;
+
+        // The waiting flag has to be visible before the ring is checked again
+        DMB();
+
+        if (spsc_empty(chan))   open = (bool)kcall(CHAN_WAIT, (k_arg_t)&chan->id);
+
+        chan->waiting = false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief   Closes the running process' end of a channel.
+ * @param   [in] chan: Pointer to the channel.
+ * @return  True if the channel was closed,
+ *          False if the process isn't one of its ends.
+ * @details The channel is freed once its consumer closes it.
+ */
+bool chan_close(spsc_ring_t* chan)
+{
+    return (bool)kcall(CHAN_CLOSE, (k_arg_t)&chan->id);
+}
+
 
 
@@ -5,7 +5,7 @@
  *          This includes kernel calls and process creation.
  * @author  Manuel Burnay
  * @date    2019.10.22  (Created)
- * @date    2019.11.29  (Last Modified)
+ * @date    2026.10.16  (Last Modified)
  */
 
 #ifndef CALLS_H
@@ -18,13 +18,15 @@
 
 /**
  * @brief   Argument structure of a process-create kernel call
- * @details Contains two arguments:
+ * @details Contains three arguments:
  *          attr: pointer to process attribute structure. Can be NULL.
  *          proc_program: pointer to reentrant function that the process will run.
+ *          job: function run on every release of a periodic process. NULL otherwise.
  */
 typedef struct pcreate_args_ {
     process_attr_t* attr;
     void (*proc_program)();
+    void (*job)(void*);
 }pcreate_args_t;
 
 /**
@@ -38,9 +40,163 @@ typedef struct request_args_ {
     pmsg_t* ret_msg;
 } request_args_t;
 
+/**
+ * @brief   Argument structure of a Reply-Wait kernel call.
+ * @details Contains two arguments:
+ *          reply: Reply message to send. Not sent if its destination isn't a valid box.
+ *          recv: Message to receive the next request onto.
+ */
+typedef struct reply_wait_args_ {
+    pmsg_t* reply;
+    pmsg_t* recv;
+} reply_wait_args_t;
+
+/**
+ * @brief   Argument structure of a Wait-Reply kernel call.
+ * @details Contains two arguments:
+ *          ticket: Ticket of the request. TICKET_ANY for any request.
+ *          msg: Message to receive the reply onto.
+ *               Its corr is set to the ticket of the reply.
+ */
+typedef struct wait_reply_args_ {
+    uint32_t    ticket;
+    pmsg_t*     msg;
+} wait_reply_args_t;
+
+/**
+ * @brief   Argument structure of a Set-Depth kernel call.
+ * @details Contains two arguments:
+ *          box: Box ID of the message box.
+ *          depth: Limit of messages queued on the box. 0 for no limit.
+ */
+typedef struct box_depth_args_ {
+    pmbox_t     box;
+    uint32_t    depth;
+} box_depth_args_t;
+
+/**
+ * @brief   Argument structure of the Subscribe and Unsubscribe kernel calls.
+ * @details Contains two arguments:
+ *          topic: Box ID of the topic.
+ *          box: Box ID of the subscriber box.
+ */
+typedef struct subscribe_args_ {
+    pmbox_t topic;
+    pmbox_t box;
+} subscribe_args_t;
+
+/**
+ * @brief   Argument structure of a Send-Async kernel call.
+ * @details Contains three arguments:
+ *          msg: Message to send.
+ *          notify: Box the completion record is posted to.
+ *          tag: Tag copied into the completion record.
+ */
+typedef struct send_async_args_ {
+    pmsg_t*     msg;
+    pmbox_t     notify;
+    uint32_t    tag;
+} send_async_args_t;
+
+/**
+ * @brief   Message descriptor used by the vectored message calls.
+ * @details Contains four fields:
+ *          dst: Destination message box of the message.
+ *          src: Source message box of the message.
+ *          data: Pointer to the message data.
+ *          size: Size of the message data (in Bytes).
+ */
+typedef struct msg_vec_ {
+    pmbox_t     dst;
+    pmbox_t     src;
+    uint8_t*    data;
+    size_t      size;
+} msg_vec_t;
+
+/**
+ * @brief   Argument structure of a Send-Many kernel call.
+ * @details Contains two arguments:
+ *          msgs: Array of messages to send.
+ *          count: Amount of messages in the array.
+ */
+typedef struct send_many_args_ {
+    msg_vec_t*  msgs;
+    uint32_t    count;
+} send_many_args_t;
+
+/**
+ * @brief   Argument structure of a Receive-Many kernel call.
+ * @details Contains five arguments:
+ *          msg: Receive buffer. Its dst is the box to receive from,
+ *               its src the source box (or ANY_BOX), and its data
+ *               and size the buffer the messages are packed into.
+ *          msgs: Array where the received messages are described.
+ *          count: Maximum amount of messages to receive.
+ *          first: Size of the first message, if the process had to block for it.
+ *          blocked: Set by the kernel if the process had to block.
+ */
+typedef struct recv_many_args_ {
+    pmsg_t      msg;
+    msg_vec_t*  msgs;
+    uint32_t    count;
+    size_t      first;
+    bool        blocked;
+} recv_many_args_t;
+
+/**
+ * @brief   Argument structure of a Receive-Any kernel call.
+ * @details Contains two arguments:
+ *          set: Bitmap of the boxes to receive from.
+ *          msg: Pointer to message to receive onto.
+ *               Its dst is set to the box the message came in on.
+ */
+typedef struct recv_any_args_ {
+    bitmap_t*   set;
+    pmsg_t*     msg;
+} recv_any_args_t;
+
+/**
+ * @brief   Argument structure of a timed Receive kernel call.
+ * @details Contains two arguments:
+ *          msg: Pointer to message to receive onto.
+ *          ms: Maximum time to wait for a message (in ms).
+ */
+typedef struct recv_timeout_args_ {
+    pmsg_t*     msg;
+    uint32_t    ms;
+} recv_timeout_args_t;
+
+/**
+ * @brief   Argument structure of a timed Request kernel call.
+ * @details Contains two arguments:
+ *          req: Request transaction arguments.
+ *          ms: Maximum time to wait for the reply (in ms).
+ */
+typedef struct request_timeout_args_ {
+    request_args_t  req;
+    uint32_t        ms;
+} request_timeout_args_t;
+
+/**
+ * @brief   Argument structure of a Set-Timer kernel call.
+ * @details Contains three arguments:
+ *          box: Message box notified when the timer expires.
+ *          ms: Time until the timer first expires (in ms).
+ *          period: Re-arm period (in ms). 0 for a one-shot timer.
+ */
+typedef struct settimer_args_ {
+    pmbox_t     box;
+    uint32_t    ms;
+    uint32_t    period;
+} settimer_args_t;
+
 inline k_ret_t kcall(k_code_t code, k_arg_t arg);
 
 pid_t pcreate(process_attr_t* attr, void (*proc_program)());
+pid_t pcreate_periodic(process_attr_t* attr, uint32_t period, uint32_t wcet,
+                       void (*job)(void*));
+void periodic_process(void* arg, void (*job)(void*));
+void wait_period(void);
 void terminate(void);
 pid_t getpid(void);
 
@@ -50,16 +206,63 @@ pmbox_t bind(pmbox_t box);
 pmbox_t unbind(pmbox_t box);
 pmbox_t getbox();
 
+pmbox_t bind_topic(pmbox_t topic);
+bool subscribe(pmbox_t topic, pmbox_t box);
+bool unsubscribe(pmbox_t topic, pmbox_t box);
+bool set_depth(pmbox_t box, uint32_t depth);
+
 size_t send(pmbox_t dst, pmbox_t src, uint8_t* data, uint32_t size);
+size_t try_send(pmbox_t dst, pmbox_t src, uint8_t* data, uint32_t size);
+size_t send_prio(pmbox_t dst, pmbox_t src, uint8_t* data, uint32_t size, uint8_t prio);
 size_t recv(pmbox_t dst, pmbox_t src, uint8_t* data, uint32_t size, pmbox_t* src_ret);
+size_t recv_any(bitmap_t* box_set, uint8_t* data, uint32_t size,
+                pmbox_t* box_ret, pmbox_t* src_ret);
+size_t try_recv(pmbox_t dst, pmbox_t src, uint8_t* data, uint32_t size, pmbox_t* src_ret);
+bool send_async(pmbox_t dst, pmbox_t src, uint8_t* data, uint32_t size,
+                pmbox_t notify, uint32_t tag);
 
 size_t request(pmbox_t dst, pmbox_t src,
                uint8_t* req, size_t req_size, uint8_t* ret, size_t ret_max);
 
+uint32_t send_many(msg_vec_t* msgs, uint32_t count);
+uint32_t recv_many(pmbox_t dst, pmbox_t src, uint8_t* buf, size_t max,
+                   msg_vec_t* msgs, uint32_t count);
+
+uint32_t request_async(pmbox_t dst, pmbox_t src, uint8_t* req, size_t req_size);
+size_t wait_reply(uint32_t ticket, uint8_t* ret, size_t ret_max);
+size_t wait_any_reply(uint8_t* ret, size_t ret_max, uint32_t* ticket_ret);
+size_t reply_wait(pmbox_t box, pmbox_t dst, uint8_t* reply, size_t reply_size,
+                  uint8_t* buf, size_t max, pmbox_t* src_ret);
+size_t recv_timeout(pmbox_t dst, pmbox_t src, uint8_t* data, uint32_t size,
+                    pmbox_t* src_ret, uint32_t ms);
+size_t request_timeout(pmbox_t dst, pmbox_t src,
+                       uint8_t* req, size_t req_size, uint8_t* ret, size_t ret_max,
+                       uint32_t ms);
+
+uint8_t* msg_loan(size_t size);
+size_t send_loaned(pmbox_t dst, pmbox_t src, uint8_t* buf, size_t size);
+size_t recv_loaned(pmbox_t dst, pmbox_t src, uint8_t** data, pmbox_t* src_ret);
+bool msg_release(uint8_t* buf);
+
 size_t send_user(pmbox_t box, char* str);
 size_t recv_user(pmbox_t box, char* buf, uint32_t max_size);
 
 void get_name(char* dst_str);
 void set_name(char* src_str);
 
+uint32_t quantum(uint32_t ms);
+
+void sleep(uint32_t ms);
+void sleep_until(uint32_t tick);
+uint32_t get_time(void);
+
+id_t settimer(pmbox_t box, uint32_t ms, uint32_t period);
+bool canceltimer(id_t id);
+
+spsc_ring_t* chan_create(uint32_t item_size);
+spsc_ring_t* chan_attach(id_t id);
+bool chan_send(spsc_ring_t* chan, const void* item);
+bool chan_recv(spsc_ring_t* chan, void* item);
+bool chan_close(spsc_ring_t* chan);
+
 #endif // CALLS_H
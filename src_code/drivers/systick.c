@@ -3,7 +3,7 @@
  * @brief   Contains all functionality of the SysTick driver.
  * @author  Manuel Burnay
  * @date    2019.09.26 (Created)
- * @date    2019.10.04 (Last Modified)
+ * @date    2026.10.16 (Last Modified)
  */
 
 #include <stdint.h>
@@ -49,7 +49,62 @@ void SysTick_Reset()
     SysTick_IntEnable();
 }
 
+/**
+ * @brief   Programs the SysTick to trigger after a single period.
+ * @param   [in] Period: Number of clock cycles until the interrupt triggers.
+ * @details The SysTick hardware keeps reloading with the same period,
+ *          so it is up to the interrupt handler to re-program it.
+ *          A pending interrupt from the previous period is discarded.
+ */
+void SysTick_OneShot(uint32_t Period)
+{
+    if (Period > MAX_WAIT)  Period = MAX_WAIT;
 
+    SysTick_SetPeriod(Period);
+    SysTick_Reset();
 
+    ST_INTCTRL_R = ST_INT_PENDCLR;
+}
 
+/**
+ * @brief   Gets the number of clock cycles counted in the current period.
+ * @return  Clock cycles elapsed since the SysTick was last (re)loaded.
+ * @details The counter reads 0 right after it's reset, until it loads the period,
+ *          and on the last cycle of a period, when the period's interrupt is already pending.
+ *          Either way no cycles of a new period have been counted, so 0 is returned
+ *          and a period that ran out is left to SysTick_Pending() or SysTick_Expired().
+ *          The COUNTFLAG can't be used for this: every read-modify-write of the
+ *          control register (e.g. SysTick_IntEnable) clears it.
+ */
+uint32_t SysTick_Elapsed()
+{
+    uint32_t current = ST_CURRENT_R;
 
+    return (current == 0) ? 0 : ST_RELOAD_R + 1 - current;
+}
+
+/**
+ * @brief   Checks if the SysTick interrupt is pending.
+ * @return  True if the SysTick period ran out without its interrupt being serviced,
+ *          False if not.
+ */
+bool SysTick_Pending()
+{
+    return (ST_INTCTRL_R & ST_INT_PENDSET) != 0;
+}
+
+/**
+ * @brief   Checks if the SysTick period ran out without its interrupt being serviced.
+ * @return  True if the SysTick interrupt is pending,
+ *          False if not.
+ * @details The pending interrupt is cleared, so the caller is expected to
+ *          account for the period that ran out.
+ */
+bool SysTick_Expired()
+{
+    bool expired = (ST_INTCTRL_R & ST_INT_PENDSET) != 0;
+
+    if (expired)    ST_INTCTRL_R = ST_INT_PENDCLR;
+
+    return expired;
+}
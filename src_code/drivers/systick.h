@@ -4,18 +4,20 @@
  *          regarding the operation of the SysTick driver
  * @author  Manuel Burnay
  * @date    2019.09.26 (Created)
- * @date    2019.10.04 (Last Modified)
+ * @date    2026.10.16 (Last Modified)
  */
 
 #ifndef SYSTICK_H
 	#define SYSTICK_H
 
 	#include <stdint.h>
+	#include <stdbool.h>
 
 	// SysTick Registers
 	#define ST_CTRL_R   	(*((volatile uint32_t*)0xE000E010))   /// SysTick Control and Status Register (STCTRL)
 	#define ST_RELOAD_R 	(*((volatile uint32_t*)0xE000E014))   /// SysTick Reload Value Register (STRELOAD)
 	#define ST_CURRENT_R 	(*((volatile uint32_t*)0xE000E018))   /// SysTick current value Register (STCURRENT)
+	#define ST_INTCTRL_R    (*((volatile uint32_t*)0xE000ED04))   /// Interrupt Control and State Register (INTCTRL)
 
 	// SysTick defines 
 	#define ST_CTRL_COUNT      0x00010000  // Count Flag for STCTRL
@@ -23,6 +25,9 @@
 	#define ST_CTRL_INTEN      0x00000002  // Interrupt Enable for STCTRL
 	#define ST_CTRL_ENABLE     0x00000001  // Enable for STCTRL
 
+	#define ST_INT_PENDSET     0x04000000  // SysTick pending flag in INTCTRL
+	#define ST_INT_PENDCLR     0x02000000  // SysTick clear-pending bit in INTCTRL
+
 	// Maximum period
 	#define MAX_WAIT    0x1000000   /* 2^24 */
 
@@ -36,6 +41,11 @@
 
 	void SysTick_Reset(void);
 
+	void SysTick_OneShot(uint32_t Period);
+	uint32_t SysTick_Elapsed(void);
+	bool SysTick_Expired(void);
+	bool SysTick_Pending(void);
+
     /** @brief   Sets the interrupt enable bit in the SysTick control register */
     #define SysTick_IntEnable()     (ST_CTRL_R |= ST_CTRL_INTEN)
 
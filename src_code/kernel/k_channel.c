@@ -0,0 +1,220 @@
+/**
+ * @file    k_channel.c
+ * @brief   Contains the kernel's single-producer/single-consumer channels.
+ * @details A channel is a lock-free ring (see spsc.h) set up by the kernel
+ *          and shared by two processes. Data goes through the ring without
+ *          kernel calls. When the ring is empty, the consumer sets the ring's
+ *          waiting flag, checks the ring again, and asks the kernel to put it
+ *          to sleep. After pushing, the producer rings the doorbell (notify)
+ *          only if it sees the waiting flag set.
+ *          Kernel calls don't interleave, so the kernel checks the ring
+ *          once more before the consumer sleeps, and no wake-up gets lost.
+ * @details This module should not be exposed to user programs.
+ * @author  Manuel Burnay
+ * @date    2026.10.16 (Created)
+ * @date    2026.10.16 (Last Modified)
+ */
+
+#include <stdint.h>
+#include "k_channel.h"
+#include "k_scheduler.h"
+#include "k_cpu.h"
+#include "bitmap.h"
+
+channel_t   channel[CHANNEL_MAX];   /// Channel table.
+
+/**
+ * @brief   Initializes the channel module.
+ */
+void k_ChanInit()
+{
+    int i;
+
+    for (i = 0; i < CHANNEL_MAX; i++) {
+        channel[i].consumer = NULL;
+        channel[i].producer = NULL;
+        channel[i].blocked = false;
+        channel[i].hung_up = false;
+    }
+}
+
+/**
+ * @brief   Creates a channel.
+ * @param   [in] slot_size: Size of the items sent through the channel (in Bytes).
+ * @param   [in] proc: Process that creates the channel. It becomes its consumer.
+ * @return  Pointer to the channel's ring,
+ *          NULL if no channel is available or the slot size doesn't fit.
+ * @details The ring gets the largest power-of-two amount of slots
+ *          that fit in the channel's memory.
+ */
+spsc_ring_t* k_ChanCreate(uint32_t slot_size, pcb_t* proc)
+{
+    channel_t* chan;
+    uint32_t id = 0;
+
+    if (slot_size == 0 || slot_size > CHANNEL_BUFFER_SIZE)  return NULL;
+
+    while (id < CHANNEL_MAX &&
+            (channel[id].consumer != NULL || channel[id].producer != NULL)) {
+        id++;
+    }
+
+    if (id >= CHANNEL_MAX)  return NULL;
+
+    chan = &channel[id];
+
+    spsc_init(&chan->ring, chan->buffer, slot_size,
+              (uint32_t)1 << ((BITMAP_WIDTH-1) - CLZ(CHANNEL_BUFFER_SIZE/slot_size)));
+
+    chan->ring.id = id;
+    chan->consumer = proc;
+    chan->producer = NULL;
+    chan->blocked = false;
+    chan->hung_up = false;
+
+    return &chan->ring;
+}
+
+/**
+ * @brief   Attaches a process to a channel as its producer.
+ * @param   [in] id: Channel ID.
+ * @param   [in] proc: Process that'll write to the channel.
+ * @return  Pointer to the channel's ring,
+ *          NULL if the channel doesn't exist or already has a producer.
+ */
+spsc_ring_t* k_ChanAttach(id_t id, pcb_t* proc)
+{
+    if (id >= CHANNEL_MAX || channel[id].consumer == NULL ||
+            channel[id].producer != NULL) {
+        return NULL;
+    }
+
+    channel[id].producer = proc;
+    channel[id].hung_up = false;
+
+    return &channel[id].ring;
+}
+
+/**
+ * @brief   Puts a channel's consumer to sleep until the producer notifies it.
+ * @param   [in] id: Channel ID.
+ * @param   [in,out] proc: Consumer of the channel.
+ * @return  True if the consumer was blocked,
+ *          False if the ring has items (or the call isn't valid).
+ * @details The consumer only sleeps if it's still flagged as waiting and
+ *          the ring is still empty.
+ */
+bool k_ChanWait(id_t id, pcb_t* proc)
+{
+    channel_t* chan = &channel[id];
+
+    if (id >= CHANNEL_MAX || chan->consumer != proc)    return false;
+
+    if (!chan->ring.waiting || !spsc_empty(&chan->ring)) {
+        chan->ring.waiting = false;
+        return false;
+    }
+
+    chan->blocked = true;
+    BlockPCB(proc, BLOCKED);
+
+    return true;
+}
+
+/**
+ * @brief   Checks if a process has nothing left to wait for on a channel.
+ * @param   [in] id: Channel ID.
+ * @param   [in] proc: Process that wants to wait on the channel.
+ * @return  True if the process isn't the channel's consumer,
+ *          or if the producer closed its end and the ring is empty.
+ *          False otherwise.
+ */
+bool k_ChanHungUp(id_t id, pcb_t* proc)
+{
+    channel_t* chan = &channel[id];
+
+    if (id >= CHANNEL_MAX || chan->consumer != proc)    return true;
+
+    return (chan->hung_up && spsc_empty(&chan->ring));
+}
+
+/**
+ * @brief   Rings a channel's doorbell, waking up its consumer.
+ * @param   [in] id: Channel ID.
+ * @param   [in] proc: Process ringing the doorbell. Has to be the channel's producer.
+ * @return  Pointer to the PCB of the consumer if it was woken up,
+ *          NULL if it wasn't asleep on the channel (or the call isn't valid).
+ * @details This function doesn't call the scheduler.
+ */
+pcb_t* k_ChanNotify(id_t id, pcb_t* proc)
+{
+    channel_t* chan = &channel[id];
+
+    if (id >= CHANNEL_MAX || chan->producer != proc || !chan->blocked) {
+        return NULL;
+    }
+
+    chan->blocked = false;
+    chan->ring.waiting = false;
+
+    WakePCB(chan->consumer);
+
+    return chan->consumer;
+}
+
+/**
+ * @brief   Closes a process' end of a channel.
+ * @param   [in] id: Channel ID.
+ * @param   [in] proc: Process closing the channel.
+ * @return  True if the process was detached from the channel,
+ *          False if it wasn't one of its ends.
+ * @details A consumer that closes its end closes the ring, so the producer
+ *          can't push into it anymore. The channel is freed once both ends
+ *          are closed, so its ring is never handed to another consumer while
+ *          the old producer can still write to it.
+ *          A producer that closes its end lets another process attach.
+ *          If the consumer is asleep on the channel when the producer
+ *          closes its end, it's woken up so it can see the channel hung up.
+ *          This function doesn't call the scheduler.
+ */
+bool k_ChanClose(id_t id, pcb_t* proc)
+{
+    channel_t* chan = &channel[id];
+
+    if (id >= CHANNEL_MAX)  return false;
+
+    if (chan->consumer == proc) {
+        chan->consumer = NULL;
+        chan->blocked = false;
+        chan->hung_up = false;
+        chan->ring.closed = true;
+    }
+    else if (chan->producer == proc) {
+        chan->producer = NULL;
+        chan->hung_up = true;
+
+        if (chan->blocked) {
+            chan->blocked = false;
+            chan->ring.waiting = false;
+            WakePCB(chan->consumer);
+        }
+    }
+    else {
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief   Closes all the channel ends of a process.
+ * @param   [in] proc: Process whose channels are closed.
+ */
+void k_ChanCloseAll(pcb_t* proc)
+{
+    int i;
+
+    for (i = 0; i < CHANNEL_MAX; i++) {
+        k_ChanClose(i, proc);
+    }
+}
@@ -0,0 +1,28 @@
+/**
+ * @file    k_channel.h
+ * @brief   Defines all functions and entities related to
+ *          the kernel's single-producer/single-consumer channels.
+ * @details This module should not be exposed to user programs.
+ * @author  Manuel Burnay
+ * @date    2026.10.16 (Created)
+ * @date    2026.10.16 (Last Modified)
+ */
+
+#ifndef K_CHANNEL_H
+#define K_CHANNEL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "k_types.h"
+
+void k_ChanInit();
+
+spsc_ring_t* k_ChanCreate(uint32_t slot_size, pcb_t* proc);
+spsc_ring_t* k_ChanAttach(id_t id, pcb_t* proc);
+bool k_ChanWait(id_t id, pcb_t* proc);
+bool k_ChanHungUp(id_t id, pcb_t* proc);
+pcb_t* k_ChanNotify(id_t id, pcb_t* proc);
+bool k_ChanClose(id_t id, pcb_t* proc);
+void k_ChanCloseAll(pcb_t* proc);
+
+#endif // K_CHANNEL_H
@@ -4,7 +4,7 @@
  *          cpu-specific operations that the embedded kernel requires.
  * @author  Manuel Burnay
  * @date    2019.11.02  (Created)
- * @date    2019.11.21  (Last Modified)
+ * @date    2026.10.16  (Last Modified)
  */
 
 #ifndef K_CPU_H
@@ -29,6 +29,9 @@ inline void PendSV_init();
 /** @brief   Disables Interrupt Requests. */
 #define DISABLE_IRQ() __asm(" cpsid i")
 
+/** @brief   Puts the CPU to sleep until an interrupt occurs. */
+#define WFI() __asm(" WFI")
+
 /** @brief   Triggers the Supervisor (kernel) Trap. */
 #define SVC()	__asm(" SVC #0")
 
@@ -3,7 +3,7 @@
  * @brief   Contains all kernel configuration definitions.
  * @author  Manuel Burnay
  * @date    2019.11.20  (Created)
- * @date    2019.11.29  (Last Modified)
+ * @date    2026.10.16  (Last Modified)
  */
 
 
@@ -14,13 +14,39 @@
 
 /************************** Scheduler Related Definitions **************************/
 
-#define PRIORITY_LEVELS 5   /// Priority levels supported by the kernel.
-#define IDLE_LEVEL      5   /// Index to the Idle queue
+/**
+ * @brief   Priority levels supported by the kernel.
+ * @details Build-time setting (e.g. -DPRIORITY_LEVELS=32).
+ *          Levels 0 and 1 are privileged, level 2 is the EDF band,
+ *          the rest are available to fixed-priority user processes.
+ */
+#ifndef PRIORITY_LEVELS
+#define PRIORITY_LEVELS 6
+#endif
+
+#if (PRIORITY_LEVELS < 4 || PRIORITY_LEVELS > 256)
+    #error "PRIORITY_LEVELS must be between 4 and 256."
+#endif
+
+#define IDLE_LEVEL      PRIORITY_LEVELS     /// Index to the Idle queue
 
 /** @brief Lowest priority supported by the system*/
-#define LOWEST_PRIORITY PRIORITY_LEVELS-1
-#define HIGH_PRIORITY   2   /// Highest priority that a user process can run on.
-#define USER_PRIORITY   3   /// Default priority for user processes
+#define LOWEST_PRIORITY (PRIORITY_LEVELS-1)
+#define HIGH_PRIORITY   3   /// Highest fixed priority that a user process can run on.
+
+/**
+ * @brief   Priority level of the Earliest-Deadline-First band.
+ * @details Processes with a deadline or period run here, ordered by absolute
+ *          deadline instead of round-robin. The band sits below the privileged
+ *          levels and above all fixed-priority user levels.
+ */
+#define EDF_PRIORITY    2
+
+/** @brief Default priority for user processes */
+#define USER_PRIORITY   ((HIGH_PRIORITY + LOWEST_PRIORITY)/2)
+
+/** @brief Priority that processes run on while their CPU budget is exhausted. */
+#define BACKGROUND_PRIORITY LOWEST_PRIORITY
 
 #define PRIV0_PRIORITY  0   /// Privileged priority 0
 #define PRIV1_PRIORITY  1   /// Privileged priority 1
@@ -29,55 +55,183 @@
  * @brief   Total amount of process levels the kernel scheduler accepts.
  *          +1 for the "Idle" queue
  */
-#define PROCESS_QUEUES  PRIORITY_LEVELS+1
+#define PROCESS_QUEUES  (PRIORITY_LEVELS+1)
+
+/***************************** Time Related Definitions ****************************/
+
+#define TICK_RATE       1000    /// Kernel tick rate in Hz. A tick is 1 ms.
+
+/**
+ * @brief   Tickless mode build setting.
+ * @details When set, the SysTick is programmed one-shot for the next kernel event
+ *          (quantum or timer expiry) instead of triggering on every tick.
+ */
+#ifndef TICKLESS_MODE
+#define TICKLESS_MODE   0
+#endif
+
+/**
+ * @brief   Amount of levels in the kernel's timer wheel.
+ * @details Every level has 32 slots, so timers up to 32^levels ticks away
+ *          are held without being re-cascaded.
+ */
+#ifndef TIMER_WHEEL_LEVELS
+#define TIMER_WHEEL_LEVELS  5
+#endif
+
+#define TIMER_MAX       32      /// Amount of user timers supported.
+
+/** @brief Error value for when an interaction with user timers goes wrong. */
+#define TIMER_ERR       PROC_ERR
 
 /*************************** Process Related Definitions ***************************/
 
 #define STACKSIZE       2048    /// Stack size allocated for the processes.
 
-#define PROC_RUNTIME    100     /// Time quantum of a process in ms
+#define PROC_RUNTIME    100     /// Default time quantum of a process in ms
+
+/**
+ * @brief   Default time quantum (in ms) of a priority level.
+ * @details Used by processes that don't set their own quantum.
+ *          Can be overridden at build time with a per-level expression.
+ */
+#ifndef LEVEL_RUNTIME
+#define LEVEL_RUNTIME(lvl)  PROC_RUNTIME
+#endif
 
 #define PID_MAX         16      /// Maximum Processes supported.
 
 #define IDLE_ID         0
 
-#if (PID_MAX/BITMAP_WIDTH == 0)
-#define PID_BITMAP_SIZE  1      /// Bitmap array size to cover all processes.
-#else
-    #define PID_BITMAP_SIZE  PID_MAX/BITMAP_WIDTH
-#endif
+/** @brief Bitmap array size to cover all processes. */
+#define PID_BITMAP_SIZE  BITMAP_SIZE(PID_MAX)
+
+/** @brief Bitmap array size to cover all priority levels. */
+#define PRIORITY_BITMAP_SIZE    BITMAP_SIZE(PRIORITY_LEVELS)
 
 /** @brief Error value for when an interaction with processes goes wrong. */
 #define PROC_ERR        -1
 
+#define UTIL_SHIFT      16  /// Fixed-point fraction bits of CPU utilization values.
+#define UTIL_ONE        (1 << UTIL_SHIFT)   /// Utilization of a fully used CPU.
+
 typedef enum PROC_STATE {
-    UNASSIGNED, WAITING_TO_RUN, RUNNING, BLOCKED, TERMINATED
+    UNASSIGNED, WAITING_TO_RUN, RUNNING, BLOCKED, SLEEPING, TERMINATED
 } proc_state;   /// All possible states for the kernel processes to be in.
 
 /***************************** IPC Related Definitions *****************************/
 
 #define BOXID_MAX   16     /// Amount of Message boxes supported by the kernel
 
-#define MSG_MAX     32     /// Amount of allocated messages in RT mode
+/**
+ * @brief   Message pool size classes.
+ * @details Messages are allocated from the smallest class that fits them,
+ *          falling back to larger classes when a class runs out.
+ *          Classes must be listed from smallest to largest.
+ */
+#define MSG_CLASSES         4
+
+#define MSG_CLASS0_SIZE     8       /// Buffer size of class 0 messages (in Bytes).
+
+#ifndef MSG_CLASS0_COUNT
+#define MSG_CLASS0_COUNT    64      /// Amount of class 0 messages. Build-time setting that sizes the pool.
+#endif
+
+#define MSG_CLASS1_SIZE     32      /// Buffer size of class 1 messages (in Bytes).
+#define MSG_CLASS1_COUNT    16      /// Amount of class 1 messages.
+#define MSG_CLASS2_SIZE     128     /// Buffer size of class 2 messages (in Bytes).
+#define MSG_CLASS2_COUNT    4       /// Amount of class 2 messages.
+#define MSG_CLASS3_SIZE     512     /// Buffer size of class 3 messages (in Bytes).
+#define MSG_CLASS3_COUNT    1       /// Amount of class 3 messages.
+
+#if (MSG_CLASS0_SIZE & (MSG_CLASS0_SIZE-1)) || (MSG_CLASS1_SIZE & (MSG_CLASS1_SIZE-1)) || \
+    (MSG_CLASS2_SIZE & (MSG_CLASS2_SIZE-1)) || (MSG_CLASS3_SIZE & (MSG_CLASS3_SIZE-1))
+    #error "Message class sizes must be powers of 2."
+#endif
+
+/** @brief Amount of allocated messages in RT mode */
+#define MSG_MAX     (MSG_CLASS0_COUNT + MSG_CLASS1_COUNT + MSG_CLASS2_COUNT + MSG_CLASS3_COUNT)
 
-#define MSG_MAX_SIZE 64    /// Max message size for messages in RT mode
+/** @brief Max message size for messages in RT mode */
+#define MSG_MAX_SIZE    MSG_CLASS3_SIZE
 
-#if (MSGBOXES_MAX/BITMAP_WIDTH == 0)
-#define MSGBOX_BITMAP_SIZE  1   /// Bitmap array size to cover all allocated message.
-#else
-    #define MSGBOX_BITMAP_SIZE  BOXID_MAX/BITMAP_WIDTH
+/**
+ * @brief   Message priority levels.
+ * @details Build-time setting. Queued messages of a higher priority are
+ *          received first. Priority 0 is the priority of regular messages.
+ */
+#ifndef MSG_PRIORITIES
+#define MSG_PRIORITIES  4
 #endif
 
-#if (MSG_MAX/BITMAP_WIDTH == 0)
-#define MSG_BITMAP_SIZE  1      /// Bitmap array size to cover all message boxes.
-#else
-    /** @brief  Bitmap array size to cover all message boxes.*/
-    #define MSG_BITMAP_SIZE  BOXID_MAX/BITMAP_WIDTH
+#if (MSG_PRIORITIES < 1 || MSG_PRIORITIES > BITMAP_WIDTH)
+    #error "MSG_PRIORITIES must be between 1 and 32."
 #endif
 
+/** @brief Amount of headers that queue a published message on a subscriber box. */
+#define MSG_REF_MAX     32
+
+/** @brief Total size of the message buffer pool (in Bytes). */
+#define MSG_POOL_SIZE   (MSG_CLASS0_SIZE*MSG_CLASS0_COUNT + MSG_CLASS1_SIZE*MSG_CLASS1_COUNT + \
+                         MSG_CLASS2_SIZE*MSG_CLASS2_COUNT + MSG_CLASS3_SIZE*MSG_CLASS3_COUNT)
+
+/** @brief Bitmap array size to cover all message boxes. */
+#define MSGBOX_BITMAP_SIZE  BITMAP_SIZE(BOXID_MAX)
+
+/** @brief  Bitmap array size to cover all allocated messages. */
+#define MSG_BITMAP_SIZE  BITMAP_SIZE(MSG_MAX)
+
 /** @brief Error value for when an interaction with processes goes wrong. */
 #define BOX_ERR     PROC_ERR
 
+/** @brief Size returned by a receive that timed out before a message arrived. */
+#define MSG_TIMEOUT ((size_t)-2)
+
+/** @brief Size returned by a non-blocking receive when no message is queued. */
+#define MSG_EMPTY   ((size_t)-3)
+
+/** @brief Size returned by a non-blocking send to a box whose queue is full. */
+#define MSG_AGAIN   ((size_t)-4)
+
+/**
+ * @brief   Default limit of messages queued on a message box.
+ * @details Build-time setting. Can be changed per box with set_depth.
+ *          Senders to a full box block until its owner takes a message out.
+ *          0 leaves boxes unbounded.
+ */
+#ifndef MSGBOX_DEPTH
+#define MSGBOX_DEPTH    16
+#endif
+
+#define ASYNC_MAX   8   /// Amount of asynchronous sends that can be in flight.
+
+/**
+ * @brief   Amount of asynchronous requests that can be outstanding at once.
+ * @details Has to be a power of 2, as a ticket's table entry is part of its value.
+ */
+#define TICKET_MAX  16
+
+#if (TICKET_MAX & (TICKET_MAX-1)) != 0
+    #error "TICKET_MAX must be a power of 2."
+#endif
+
+#define TICKET_NONE 0           /// Ticket of messages that aren't part of an asynchronous request.
+#define TICKET_ANY  0xFFFFFFFF  /// Ticket value used to wait on the reply of any request.
+
+/** @brief Ownership of a message buffer, tracked for the zero-copy loan API. */
+typedef enum MSG_OWNERSHIP {
+    MSG_OWN_KERNEL,     /**< Plain message, or pool message held by the kernel. */
+    MSG_OWN_LOANED,     /**< Pool message loaned to a sender that writes it in place. */
+    MSG_OWN_BORROWED,   /**< Pool message lent to a receiver that reads it in place. */
+    MSG_OWN_BORROW      /**< Receive slot that asks for a borrowed buffer instead of a copy. */
+} msg_own_t;
+
+#define CHANNEL_MAX         4       /// Amount of SPSC channels supported.
+#define CHANNEL_BUFFER_SIZE 512     /// Size of a channel's ring memory (in Bytes).
+
+/** @brief Error value for when an interaction with channels goes wrong. */
+#define CHAN_ERR    PROC_ERR
+
 /** @brief Indicator that box ID is unimportant for the current operation. */
 #define ANY_BOX     BOXID_MAX
 
@@ -95,7 +249,17 @@ typedef enum KERNEL_CALL_CODES {
     PCREATE, STARTUP, GETPID, NICE,
     BIND, UNBIND, SEND,   RECV,
     REQUEST, GETBOX, SEND_USER, RECV_USER,
-    GET_NAME, SET_NAME, TERMINATE
+    GET_NAME, SET_NAME, TERMINATE,
+    QUANTUM, SLEEP, SLEEP_UNTIL, GET_TIME,
+    SET_TIMER, CANCEL_TIMER, RECV_TIMEOUT, REQUEST_TIMEOUT,
+    WAIT_PERIOD, REPLY_WAIT,
+    MSG_LOAN, SEND_LOANED, RECV_LOANED, MSG_RELEASE,
+    SEND_MANY, RECV_MANY,
+    TOPIC_BIND, SUBSCRIBE, UNSUBSCRIBE,
+    CHAN_CREATE, CHAN_ATTACH, CHAN_WAIT, CHAN_NOTIFY, CHAN_CLOSE,
+    RECV_ANY, TRY_RECV, SEND_ASYNC,
+    REQUEST_ASYNC, WAIT_REPLY,
+    TRY_SEND, SET_DEPTH
 } k_code_t; /** All Kernel Calls supported to the user. */
 
 #endif // K_DEFINITIONS_H
@@ -5,7 +5,7 @@
  * @details This module should not be exposed to user programs.
  * @author  Manuel Burnay
  * @date    2019.10.23 (Created)
- * @date    2019.11.29 (Last Modified)
+ * @date    2026.10.16 (Last Modified)
  */
 
 #include <stdlib.h>
@@ -16,6 +16,8 @@
 #include "k_processes.h"
 #include "k_cpu.h"
 #include "k_messaging.h"
+#include "k_timer.h"
+#include "k_channel.h"
 #include "dlist.h"
 #include "uart.h"
 #include "systick.h"
@@ -24,6 +26,7 @@
 pcb_t *running, *pTerminal, *pIdle;
 
 extern pcb_t   proc_table[PID_MAX];
+extern uint32_t SysTickCount;
 extern pmsgbox_t msgbox[BOXID_MAX];
 
 /**
@@ -33,10 +36,12 @@ void kernel_init()
 {
     PendSV_init();
 
+    scheduler_init();
     process_init();
     k_MsgInit();
+    k_ChanInit();
 
-    SysTick_Init(1000);  // 1000 Hz rate -> system tick triggers every milisecond
+    k_TimerInit();  // TICK_RATE of 1000 Hz -> system tick is a milisecond
 
     UART0_Init();
 
@@ -48,12 +53,14 @@ void kernel_init()
 
     pIdle = GetPCB(k_pcreate(&pattr, &idle, &terminate));
     LinkPCB(pIdle, IDLE_LEVEL);
+    pIdle->base_priority = IDLE_LEVEL;
 
     // Register the Terminal server process
     strcpy(pattr.name, "terminal");
 
     pTerminal = GetPCB(k_pcreate(&pattr, &terminal, &terminate));
     LinkPCB(pTerminal, PRIV0_PRIORITY);
+    pTerminal->base_priority = PRIV0_PRIORITY;
 }
 
 /**
@@ -73,16 +80,33 @@ inline void kernel_start()
  * @brief   System Tick Exception handler.
  * @details Manages the running process' allotted runtime
  *          and to provide the system an accurate time-keeping system.
- * @todo    Implement a sleep feature for the processes.
+ *          In tickless mode the handler only triggers when a kernel event is due,
+ *          and the elapsed time is taken from the SysTick counter.
+ *          Processes woken up by expired timers are scheduled right away,
+ *          and so are processes that exhausted their CPU budget.
+ *          User timers are only marked as fired here, their messages are sent from PendSV.
  */
 void SystemTick_handler(void)
 {
-    running->timer--;
-    if (running->timer == 0) {
+#if TICKLESS_MODE
+    uint32_t ticks = k_TickElapsed(true);
+#else
+    uint32_t ticks = 1;
+#endif
+
+    SysTickCount++;
+
+    running->timer -= ticks;
+
+    bool throttled = ChargeBudget(running, ticks);
+
+    if (k_TimeAdvance(ticks) || running->timer <= 0 || throttled) {
         PendSV();
     }
 
-    // Do time queue thing
+#if TICKLESS_MODE
+    k_TickProgram((running->timer > 0) ? running->timer : 1);
+#endif
 }
 
 /**
@@ -94,22 +118,32 @@ void SystemTick_handler(void)
 void PendSV_handler(void)
 {
     DISABLE_IRQ();  // Disable interrupts to procedure doesn't get corrupted
-    SysTick_Stop();
+
+#if TICKLESS_MODE
+    ChargeBudget(running, k_TickSync());
+#endif
+
+    // User timers that fired in the SysTick interrupt notify their boxes
+    k_UserTimerNotify();
 
     SaveProcessContext();
     running->sp = (uint32_t*)GetPSP();
 
-    if (running->state == RUNNING)  running->state = WAITING_TO_RUN;
+    pcb_t* prev = running;
+    bool preempted = (running->state == RUNNING);
+
+    if (preempted)  running->state = WAITING_TO_RUN;
     running = Schedule();
     running->state = RUNNING;
 
+    // Process was switched out without yielding or blocking
+    if (preempted && prev != running)   prev->preemptions++;
+
     SetPSP((uint32_t)running->sp);
     RestoreProcessContext();
 
-    running->timer = PROC_RUNTIME;
+    k_StartQuantum();
 
-    SysTick_Reset();
-    SysTick_Start();
     ENABLE_IRQ();
 }
 
@@ -117,13 +151,14 @@ void PendSV_handler(void)
  * @brief   Supervisor Call trap handler.
  * @details Trap handler has been structured so it's as CPU-generic as possible.
  *          CPU-specific implementation is done in the k_cpu module.
+ *          The SysTick keeps counting through the trap, so no kernel time is lost.
+ *          Its interrupt has the same priority as this trap, so a tick that
+ *          comes due is serviced once the trap returns.
  */
 void SVC_handler() 
 {
     SaveTrapReturn();   // save the trap return address
 
-    SysTick_Stop();
-
     if (TrapSource() == KERNEL) {   // Check if the trap was called by the kernel
         // In which case the kernel needs to save its own context
         SaveContext();
@@ -136,8 +171,6 @@ void SVC_handler()
         RestoreProcessContext();
     }
 
-    SysTick_Start();
-
     RestoreTrapReturn();
 }
 
@@ -163,10 +196,8 @@ void KernelCall_handler(k_call_t* call)
 
             RestoreProcessContext();
 
-            running->timer = PROC_RUNTIME;
-
             // Reset the System timer
-            SysTick_Reset();
+            k_StartQuantum();
             SysTick_Start();
 
             StartProcess();
@@ -192,18 +223,119 @@ void KernelCall_handler(k_call_t* call)
             call->retval = k_getboxCall();
         } break;
 
+        case TOPIC_BIND: {
+            call->retval = k_MsgTopicBind(*(pmbox_t*)call->arg, running);
+        } break;
+
+        case SUBSCRIBE: {
+            subscribe_args_t* args = (subscribe_args_t*)call->arg;
+            call->retval = k_MsgSubscribe(args->topic, args->box, running);
+        } break;
+
+        case UNSUBSCRIBE: {
+            subscribe_args_t* args = (subscribe_args_t*)call->arg;
+            call->retval = k_MsgUnsubscribe(args->topic, args->box, running);
+        } break;
+
+        case CHAN_CREATE: {
+            call->retval = (k_ret_t)k_ChanCreate(*(uint32_t*)call->arg, running);
+        } break;
+
+        case CHAN_ATTACH: {
+            call->retval = (k_ret_t)k_ChanAttach(*(id_t*)call->arg, running);
+        } break;
+
+        case CHAN_WAIT: {
+            call->retval = k_chanWaitCall((id_t*)call->arg);
+        } break;
+
+        case CHAN_NOTIFY: {
+            k_chanNotifyCall((id_t*)call->arg);
+        } break;
+
+        case CHAN_CLOSE: {
+            // Closing the producer end might have woken up the consumer
+            call->retval = k_ChanClose(*(id_t*)call->arg, running);
+            if (call->retval)   PendSV();
+        } break;
+
         case SEND: {
             k_sendCall((pmsg_t*)call->arg, &call->retval);
         } break;
 
+        case TRY_SEND: {
+            k_trySendCall((pmsg_t*)call->arg, &call->retval);
+        } break;
+
+        case SET_DEPTH: {
+            box_depth_args_t* args = (box_depth_args_t*)call->arg;
+            call->retval = k_MsgBoxSetDepth(args->box, args->depth, running);
+        } break;
+
         case RECV: {
             k_recvCall((pmsg_t*)call->arg, &call->retval);
         } break;
 
+        case TRY_RECV: {
+            k_tryRecvCall((pmsg_t*)call->arg, &call->retval);
+        } break;
+
+        case SEND_ASYNC: {
+            call->retval = k_sendAsyncCall((send_async_args_t*)call->arg);
+        } break;
+
+        case RECV_ANY: {
+            k_recvAnyCall((recv_any_args_t*)call->arg, &call->retval);
+        } break;
+
+        case SEND_MANY: {
+            call->retval = k_sendManyCall((send_many_args_t*)call->arg);
+        } break;
+
+        case RECV_MANY: {
+            k_recvManyCall((recv_many_args_t*)call->arg, &call->retval);
+        } break;
+
         case REQUEST: {
             k_requestCall((request_args_t*)call->arg, &call->retval);
         } break;
 
+        case REPLY_WAIT: {
+            k_replyWaitCall((reply_wait_args_t*)call->arg, &call->retval);
+        } break;
+
+        case REQUEST_ASYNC: {
+            call->retval = k_requestAsyncCall((pmsg_t*)call->arg);
+        } break;
+
+        case WAIT_REPLY: {
+            k_waitReplyCall((wait_reply_args_t*)call->arg, &call->retval);
+        } break;
+
+        case MSG_LOAN: {
+            call->retval = (k_ret_t)k_loanCall((size_t*)call->arg);
+        } break;
+
+        case SEND_LOANED: {
+            k_sendLoanedCall((pmsg_t*)call->arg, &call->retval);
+        } break;
+
+        case RECV_LOANED: {
+            k_recvLoanedCall((pmsg_t*)call->arg, &call->retval);
+        } break;
+
+        case MSG_RELEASE: {
+            call->retval = k_releaseCall((uint8_t*)call->arg);
+        } break;
+
+        case RECV_TIMEOUT: {
+            k_recvTimeoutCall((recv_timeout_args_t*)call->arg, &call->retval);
+        } break;
+
+        case REQUEST_TIMEOUT: {
+            k_requestTimeoutCall((request_timeout_args_t*)call->arg, &call->retval);
+        } break;
+
         case TERMINATE: {
             k_Terminate();
         } break;
@@ -216,9 +348,65 @@ void KernelCall_handler(k_call_t* call)
             k_setnameCall((char*)call->arg);
         } break;
 
+        case QUANTUM: {
+            call->retval = k_quantumCall((uint32_t*)call->arg);
+        } break;
+
+        case SLEEP: {
+            k_sleepCall((uint32_t*)call->arg);
+        } break;
+
+        case SLEEP_UNTIL: {
+            k_sleepUntilCall((uint32_t*)call->arg);
+        } break;
+
+        case WAIT_PERIOD: {
+            k_waitPeriodCall();
+        } break;
+
+        case GET_TIME: {
+            call->retval = k_GetTime();
+        } break;
+
+        case SET_TIMER: {
+            call->retval = k_setTimerCall((settimer_args_t*)call->arg);
+        } break;
+
+        case CANCEL_TIMER: {
+            call->retval = k_UserTimerCancel(running, *(id_t*)call->arg);
+        } break;
+
         default: {
         } break;
     }
+
+    // Messages freed by the call can let held asynchronous sends through
+    if (k_MsgAsyncPending())    k_MsgAsyncRetry();
+}
+
+/**
+ * @brief   Starts the running process' time quantum.
+ * @details Reloads the process timer.
+ *          Since it runs on every dispatch, it also records job start times.
+ *          In tickless mode the SysTick is programmed for the quantum's expiry.
+ *          The SysTick's enable state is left untouched.
+ */
+void k_StartQuantum()
+{
+    running->timer = GetQuantum(running);
+    JobStart(running);
+
+    // The SysTick has to catch the process running out of budget
+    if (running->budget != 0 && !running->throttled &&
+            running->budget_left < running->timer) {
+        running->timer = running->budget_left;
+    }
+
+    // In periodic mode the SysTick isn't reset, so the time of the current tick
+    // isn't lost. The quantum's first tick can be a partial one.
+#if TICKLESS_MODE
+    k_TickProgram(running->timer);
+#endif
 }
 
 /**
@@ -229,7 +417,14 @@ void KernelCall_handler(k_call_t* call)
  */
 inline pid_t k_pcreateCall(pcreate_args_t* arg)
 {
-    return k_pcreate(arg->attr, arg->proc_program, &terminate);
+    pid_t id = k_pcreate(arg->attr, arg->proc_program, &terminate);
+
+    // Periodic processes get their job as the program's second argument
+    if (id != (pid_t)PROC_ERR && arg->job != NULL) {
+        ((cpu_context_t*)GetPCB(id)->sp)->r1 = (uint32_t)arg->job;
+    }
+
+    return id;
 }
 
 /**
@@ -247,13 +442,24 @@ inline pid_t getpidCall()
  * @return  Running process' priority after all operations are complete.
  * @details This function ensures the user process doesn't change
  *          to an invalid/unallowed priority.
+ *          The switch that follows is a voluntary one,
+ *          so it isn't counted as a preemption.
+ *          EDF processes keep their place in the EDF band.
+ *          A throttled process only moves once its budget is replenished,
+ *          and a process that inherited a higher priority keeps it.
+ *          Admitted periodic processes can't leave rate-monotonic order,
+ *          which their admission test relies on.
  */
 inline priority_t niceCall(priority_t* new)
 {
-    if ((*new) > PRIV1_PRIORITY && (*new) < PRIORITY_LEVELS) {
-        LinkPCB(running, (*new));
+    if ((*new) >= HIGH_PRIORITY && (*new) <= LOWEST_PRIORITY && !IsEDF(running) &&
+            (running->utilization == 0 || k_RateMonotonic(running, running->period, *new))) {
+        running->base_priority = (*new);
+        UpdatePriority(running);
     }
 
+    running->state = WAITING_TO_RUN;
+
     PendSV();
 
     return running->priority;
@@ -305,8 +511,69 @@ inline pmbox_t k_getboxCall()
  */
 inline void k_sendCall(pmsg_t* msg, size_t* retsize)
 {
+    // Only the kernel can mark a message as a pool message
+    msg->flags = MSG_OWN_KERNEL;
+
+    k_SendMessage(msg, retsize, true);
+}
+
+/**
+ * @brief   Performs all operations required to send a message without blocking.
+ * @param   [in] msg: message to send to a message box.
+ * @param   [out] retsize: number of bytes successfully sent,
+ *                         or MSG_AGAIN if the box' queue is full.
+ */
+inline void k_trySendCall(pmsg_t* msg, size_t* retsize)
+{
+    msg->flags = MSG_OWN_KERNEL;
+
+    k_SendMessage(msg, retsize, false);
+}
+
+/**
+ * @brief   Sends a message from a box belonging to the running process.
+ * @param   [in] msg: message to send to a message box.
+ * @param   [out] retsize: number of bytes successfully sent,
+ *                         or MSG_AGAIN if the box is full and block is false.
+ * @param   [in] block: Whether the process waits for room in a full box.
+ * @details A reply to a client blocked on a request switches straight
+ *          back to the client when it can.
+ *          A process never blocks on a box it owns, it gets MSG_AGAIN instead.
+ */
+void k_SendMessage(pmsg_t* msg, size_t* retsize, bool block)
+{
+    pcb_t* receiver;
+    bool reply;
+
     if (msg->dst < BOXID_MAX && msgbox[msg->src].owner == running) {
-        k_MsgSend(msg, retsize);
+        if (!k_MsgAdmitted(msg)) {
+            if (block && msgbox[msg->dst].owner != running) {
+                k_MsgSendWait(msg, retsize, running);
+                PendSV();
+            }
+            else {
+                (*retsize) = MSG_AGAIN;
+            }
+
+            return;
+        }
+
+        // A client blocked on a request is waiting for this as a reply
+        reply = msgbox[msg->dst].owner != NULL &&
+                msgbox[msg->dst].owner->req_box < BOXID_MAX;
+
+        receiver = k_MsgDeliver(msg, retsize);
+
+        if (receiver != NULL) {
+            // Replies (or sends to a higher priority) switch straight to the receiver
+            if ((reply || receiver->priority < running->priority) &&
+                    CanHandoff(receiver)) {
+                k_Handoff(receiver);
+            }
+            else {
+                PendSV();
+            }
+        }
     }
     else {
         *retsize = 0;
@@ -321,6 +588,263 @@ inline void k_sendCall(pmsg_t* msg, size_t* retsize)
  */
 inline void k_recvCall(pmsg_t* msg, size_t* retsize)
 {
+    msg->flags = MSG_OWN_KERNEL;
+
+    if (msg->dst < BOXID_MAX && msgbox[msg->dst].owner == running) {
+        k_MsgRecv(msg, retsize);
+    }
+    else {
+        *retsize = 0;
+    }
+}
+
+/**
+ * @brief   Performs all operations required to receive a message without blocking.
+ * @param   [in,out] msg: destination of message to be received from a message box.
+ * @param   [out] retsize: number of bytes successfully received,
+ *                         or MSG_EMPTY if no message was queued.
+ */
+inline void k_tryRecvCall(pmsg_t* msg, size_t* retsize)
+{
+    msg->flags = MSG_OWN_KERNEL;
+
+    if (msg->dst < BOXID_MAX && msgbox[msg->dst].owner == running) {
+        if (!k_MsgFetch(msg, retsize))  (*retsize) = MSG_EMPTY;
+    }
+    else {
+        *retsize = 0;
+    }
+}
+
+/**
+ * @brief   Performs all operations required to start an asynchronous send.
+ * @param   [in] args: Send-async arguments.
+ * @return  True if the send was taken in,
+ *          False otherwise.
+ */
+inline bool k_sendAsyncCall(send_async_args_t* args)
+{
+    pmsg_t* msg = args->msg;
+
+    if (msg->dst >= BOXID_MAX || msg->src >= BOXID_MAX || msg->size == 0 ||
+            msgbox[msg->src].owner != running ||
+            args->notify >= BOXID_MAX || msgbox[args->notify].owner != running) {
+        return false;
+    }
+
+    return k_MsgSendAsync(msg, args->notify, args->tag, running);
+}
+
+/**
+ * @brief   Performs all operations required to receive a message
+ *          from any box of a set owned by the running process.
+ * @param   [in,out] args: Receive-any arguments.
+ * @param   [out] retsize: number of bytes successfully received.
+ * @details Nothing is received if the set is empty or
+ *          has a box the running process doesn't own.
+ */
+inline void k_recvAnyCall(recv_any_args_t* args, size_t* retsize)
+{
+    uint32_t box = FindSet(args->set, 0, BOXID_MAX);
+
+    (*retsize) = 0;
+
+    if (box >= BOXID_MAX)   return;
+
+    while (box < BOXID_MAX) {
+        if (msgbox[box].owner != running)   return;
+        box = FindSet(args->set, box+1, BOXID_MAX);
+    }
+
+    args->msg->flags = MSG_OWN_KERNEL;
+
+    if (!k_MsgFetchAny(args->msg, args->set, retsize)) {
+        k_MsgWaitAny(args->msg, args->set, retsize, running);
+        PendSV();
+    }
+}
+
+/**
+ * @brief   Performs all operations required to send a batch of messages.
+ * @param   [in,out] args: Send-many arguments. Each message's size is
+ *                         overwritten with the amount of bytes sent.
+ * @return  Amount of messages sent.
+ * @details Receivers woken up by the messages are only scheduled
+ *          once all messages were sent. Messages to a full box
+ *          aren't sent, and get MSG_AGAIN as their size.
+ */
+inline uint32_t k_sendManyCall(send_many_args_t* args)
+{
+    pmsg_t msg = {.flags = MSG_OWN_KERNEL};
+    msg_vec_t* vec;
+    bool woken = false;
+    uint32_t sent = 0;
+
+    uint32_t i;
+    for (i = 0; i < args->count; i++) {
+        vec = &args->msgs[i];
+
+        if (vec->dst < BOXID_MAX && vec->src < BOXID_MAX &&
+                msgbox[vec->src].owner == running) {
+            msg.dst = vec->dst;
+            msg.src = vec->src;
+            msg.data = vec->data;
+            msg.size = vec->size;
+            msg.corr = TICKET_NONE;
+
+            if (!k_MsgAdmitted(&msg)) {
+                vec->size = MSG_AGAIN;
+                continue;
+            }
+
+            if (k_MsgDeliver(&msg, &vec->size) != NULL)  woken = true;
+            if (vec->size != 0)  sent++;
+        }
+        else {
+            vec->size = 0;
+        }
+    }
+
+    if (woken)  PendSV();
+
+    return sent;
+}
+
+/**
+ * @brief   Performs all operations required to receive a batch of queued messages.
+ * @param   [in,out] args: Receive-many arguments.
+ * @param   [out] retval: Amount of messages received.
+ * @details Messages are packed word-aligned into the receive buffer.
+ *          If no message is queued the process blocks on the first one.
+ */
+inline void k_recvManyCall(recv_many_args_t* args, uint32_t* retval)
+{
+    pmsg_t* box_msg = &args->msg;
+    pmsg_t slot = {.flags = MSG_OWN_KERNEL};
+    pmsg_t* head;
+    size_t used = 0, size;
+
+    (*retval) = 0;
+
+    if (box_msg->dst >= BOXID_MAX || msgbox[box_msg->dst].owner != running) return;
+
+    slot.dst = box_msg->dst;
+    slot.src = box_msg->src;
+
+    while ((*retval) < args->count) {
+        head = k_MsgPeek(box_msg->dst, box_msg->src);
+
+        // Only the first message is truncated to fit
+        if (head == NULL || ((*retval) != 0 && used + head->size > box_msg->size))   break;
+
+        slot.src = box_msg->src;
+        slot.data = box_msg->data + used;
+        slot.size = box_msg->size - used;
+
+        k_MsgFetch(&slot, &size);
+
+        args->msgs[*retval].dst = slot.dst;
+        args->msgs[*retval].src = slot.src;
+        args->msgs[*retval].data = slot.data;
+        args->msgs[*retval].size = size;
+        (*retval)++;
+
+        used = (used + size + 3) & ~3;
+        if (used >= box_msg->size)  break;
+    }
+
+    if ((*retval) == 0 && args->count != 0) {
+        box_msg->flags = MSG_OWN_KERNEL;
+        args->blocked = true;
+        (*retval) = 1;
+
+        k_MsgWait(box_msg, &args->first);
+        PendSV();
+    }
+}
+
+/**
+ * @brief   Performs all operations required to put a channel's consumer to sleep.
+ * @param   [in] id: Pointer to the channel ID.
+ * @return  True if the consumer can keep waiting on the channel,
+ *          False if the producer hung up and the channel is drained
+ *          (or the running process isn't the channel's consumer).
+ */
+inline bool k_chanWaitCall(id_t* id)
+{
+    if (k_ChanHungUp(*id, running)) return false;
+
+    if (k_ChanWait(*id, running))   PendSV();
+
+    return true;
+}
+
+/**
+ * @brief   Performs all operations required to ring a channel's doorbell.
+ * @param   [in] id: Pointer to the channel ID.
+ * @details A consumer with a higher priority than the producer
+ *          is switched to straight away.
+ */
+inline void k_chanNotifyCall(id_t* id)
+{
+    pcb_t* consumer = k_ChanNotify(*id, running);
+
+    if (consumer != NULL) {
+        if (consumer->priority < running->priority && CanHandoff(consumer)) {
+            k_Handoff(consumer);
+        }
+        else {
+            PendSV();
+        }
+    }
+}
+
+/**
+ * @brief   Performs all operations required to loan a pool message to the running process.
+ * @param   [in] size: Size of the message the process will write.
+ * @return  Pointer to the loaned buffer,
+ *          NULL if no buffer could be loaned.
+ */
+inline uint8_t* k_loanCall(size_t* size)
+{
+    pmsg_t* msg = k_MsgLoan((*size), running);
+
+    return (msg != NULL) ? msg->data : NULL;
+}
+
+/**
+ * @brief   Performs all operations required to send a loaned message
+ *          without copying it.
+ * @param   [in] msg: message whose data points to a buffer loaned to the process.
+ * @param   [out] retsize: number of bytes successfully sent.
+ * @details The buffer stays loaned to the process if the message can't be sent.
+ */
+inline void k_sendLoanedCall(pmsg_t* msg, size_t* retsize)
+{
+    pmsg_t* loaned = k_MsgLoanLookup(msg->data, running);
+
+    if (loaned == NULL || loaned->flags != MSG_OWN_LOANED) {
+        (*retsize) = 0;
+        return;
+    }
+
+    loaned->dst = msg->dst;
+    loaned->src = msg->src;
+    if (msg->size < loaned->size)   loaned->size = msg->size;
+
+    k_SendMessage(loaned, retsize, true);
+}
+
+/**
+ * @brief   Performs all operations required to receive a message
+ *          by borrowing its buffer instead of copying it.
+ * @param   [in,out] msg: message slot. Its data gets pointed to the borrowed buffer.
+ * @param   [out] retsize: number of bytes successfully received.
+ */
+inline void k_recvLoanedCall(pmsg_t* msg, size_t* retsize)
+{
+    msg->flags = MSG_OWN_BORROW;
+
     if (msg->dst < BOXID_MAX && msgbox[msg->dst].owner == running) {
         k_MsgRecv(msg, retsize);
     }
@@ -329,21 +853,69 @@ inline void k_recvCall(pmsg_t* msg, size_t* retsize)
     }
 }
 
+/**
+ * @brief   Performs all operations required to return a loaned
+ *          or borrowed buffer to the pool.
+ * @param   [in] data: Pointer to the buffer.
+ * @return  True if the buffer was released,
+ *          False if it isn't held by the running process.
+ */
+inline bool k_releaseCall(uint8_t* data)
+{
+    pmsg_t* msg = k_MsgLoanLookup(data, running);
+
+    if (msg != NULL)    k_MsgRelease(msg);
+
+    return (msg != NULL);
+}
+
 /**
  * @brief   Performs all operations required to perform the request transaction
  *          between a message box belonging to the running process to another.
  * @param   [in,out] args: Request transaction arguments.
  * @param   [out] retsize:
  *              number of bytes successfully received on the reply message.
+ * @details If the server was waiting on the request, the kernel switches
+ *          straight to it instead of going through the scheduler.
+ *          The client blocks on the reply, so its request skips the server box'
+ *          depth limit. That only holds while the client has no other unanswered
+ *          request to the box (e.g. one it timed out on), otherwise a full box
+ *          returns MSG_AGAIN.
  */
 inline void k_requestCall(request_args_t* arg, size_t* retsize)
 {
+    pcb_t* server;
+
+    arg->req_msg->flags = MSG_OWN_KERNEL;
+    arg->ret_msg->flags = MSG_OWN_KERNEL;
+
     if (arg->req_msg->dst < BOXID_MAX &&
             msgbox[arg->req_msg->src].owner == running) {
 
-        k_MsgSend(arg->req_msg, retsize);
-        if ((*retsize) != 0) {
-            k_MsgRecv(arg->ret_msg, retsize);
+        if (k_MsgTicketMatch(arg->req_msg->src, arg->req_msg->dst) != TICKET_NONE &&
+                !k_MsgAdmitted(arg->req_msg)) {
+            (*retsize) = MSG_AGAIN;
+            return;
+        }
+
+        server = k_MsgDeliver(arg->req_msg, retsize);
+
+        if ((*retsize) == 0) {
+            if (server != NULL) PendSV();
+        }
+        else if (k_MsgFetch(arg->ret_msg, retsize)) {
+            if (server != NULL) PendSV();
+        }
+        else {
+            k_MsgWait(arg->ret_msg, retsize);
+
+            // The server runs on the client's behalf until it replies,
+            // unless a send it was blocked on already was the reply
+            if (running->state == BLOCKED)  k_MsgRequestStart(running, arg->req_msg->dst);
+
+            // Switch straight to a server that was waiting on the request
+            if (server != NULL && CanHandoff(server))   k_Handoff(server);
+            else                                        PendSV();
         }
     }
     else {
@@ -351,6 +923,174 @@ inline void k_requestCall(request_args_t* arg, size_t* retsize)
     }
 }
 
+/**
+ * @brief   Performs all operations required to reply to a client
+ *          and wait for the next request, in a single kernel call.
+ * @param   [in,out] args: Reply-wait arguments.
+ * @param   [out] retsize: number of bytes successfully received on the next request.
+ * @details If the server blocks and the client it replied to can run next,
+ *          the kernel switches straight to the client.
+ *          A reply the client isn't waiting on and has no ticket for
+ *          is held to the client box' depth limit, and dropped if the box is full.
+ */
+inline void k_replyWaitCall(reply_wait_args_t* args, size_t* retsize)
+{
+    pmbox_t box = args->recv->dst;
+    pcb_t* client = NULL;
+    size_t sent;
+
+    (*retsize) = 0;
+
+    args->reply->flags = MSG_OWN_KERNEL;
+    args->recv->flags = MSG_OWN_KERNEL;
+
+    if (box >= BOXID_MAX || msgbox[box].owner != running) return;
+
+    if (args->reply->dst < BOXID_MAX) {
+        args->reply->src = box;
+        if (k_MsgAdmitted(args->reply)) client = k_MsgDeliver(args->reply, &sent);
+    }
+
+    if (k_MsgFetch(args->recv, retsize)) {
+        // Next request was already queued, so the server keeps going
+        if (client != NULL) PendSV();
+    }
+    else {
+        k_MsgWait(args->recv, retsize);
+
+        if (client != NULL && CanHandoff(client))   k_Handoff(client);
+        else                                        PendSV();
+    }
+}
+
+/**
+ * @brief   Performs all operations required to start an asynchronous request
+ *          from a message box belonging to the running process.
+ * @param   [in,out] msg: Request message. Its corr is set to the issued ticket.
+ * @return  Ticket of the request,
+ *          TICKET_NONE if the request couldn't be sent.
+ * @details The client keeps running. The reply is held by the ticket
+ *          until the client waits on it.
+ *          Since a client can have several of these outstanding,
+ *          the request is held to the server box' depth limit, without blocking.
+ */
+inline uint32_t k_requestAsyncCall(pmsg_t* msg)
+{
+    rpc_ticket_t* t;
+    pcb_t* server;
+    size_t size;
+
+    msg->flags = MSG_OWN_KERNEL;
+
+    if (msg->dst >= BOXID_MAX || msg->src >= BOXID_MAX ||
+            msgbox[msg->src].owner != running) {
+        return TICKET_NONE;
+    }
+
+    t = k_MsgTicketIssue(msg->src, msg->dst, running);
+
+    if (t == NULL)  return TICKET_NONE;
+
+    msg->corr = t->id;
+
+    if (!k_MsgAdmitted(msg)) {
+        k_MsgTicketFree(t);
+        return TICKET_NONE;
+    }
+
+    server = k_MsgDeliver(msg, &size);
+
+    if (server == NULL && size == 0) {
+        k_MsgTicketFree(t);
+        return TICKET_NONE;
+    }
+
+    if (server != NULL) PendSV();
+
+    return msg->corr;
+}
+
+/**
+ * @brief   Performs all operations required to wait on the reply
+ *          to an asynchronous request.
+ * @param   [in,out] args: Wait-reply arguments.
+ * @param   [out] retsize: number of bytes successfully received,
+ *                         or MSG_EMPTY if the running process has no such request.
+ */
+inline void k_waitReplyCall(wait_reply_args_t* args, size_t* retsize)
+{
+    args->msg->flags = MSG_OWN_KERNEL;
+
+    if (k_MsgFetchReply(args->msg, args->ticket, running, retsize))  return;
+
+    if (k_MsgTicketHeld(args->ticket, running)) {
+        k_MsgWaitReply(args->msg, args->ticket, retsize, running);
+        PendSV();
+    }
+    else {
+        (*retsize) = MSG_EMPTY;
+    }
+}
+
+/**
+ * @brief   Switches from the running process to another, within a kernel call.
+ * @param   [in,out] next: Pointer to the PCB of a process that is ready to run.
+ * @details This is the IPC fast path: it skips the PendSV trap and the
+ *          scheduling pass. The new process' context is restored when the
+ *          kernel call returns. The caller has to make sure the process
+ *          is one Schedule() could pick (see CanHandoff).
+ */
+void k_Handoff(pcb_t* next)
+{
+#if TICKLESS_MODE
+    ChargeBudget(running, k_TickSync());
+#endif
+
+    running->sp = (uint32_t*)GetPSP();
+    if (running->state == RUNNING)  running->state = WAITING_TO_RUN;
+
+    running = next;
+    running->state = RUNNING;
+    SetPSP((uint32_t)running->sp);
+
+    k_StartQuantum();
+}
+
+/**
+ * @brief   Performs all operations required to receive a message,
+ *          waiting for a limited amount of time.
+ * @param   [in,out] args: Timed receive arguments.
+ * @param   [out] retsize: number of bytes successfully received,
+ *                         or MSG_TIMEOUT once the wait expires.
+ */
+inline void k_recvTimeoutCall(recv_timeout_args_t* args, size_t* retsize)
+{
+    k_recvCall(args->msg, retsize);
+
+    if (running->state == BLOCKED) {
+        k_MsgTimeoutStart(args->msg->dst, args->ms);
+    }
+}
+
+/**
+ * @brief   Performs all operations required to perform a request transaction,
+ *          waiting for the reply for a limited amount of time.
+ * @param   [in,out] args: Timed request arguments.
+ * @param   [out] retsize: number of bytes successfully received on the reply,
+ *                         or MSG_TIMEOUT once the wait expires.
+ */
+inline void k_requestTimeoutCall(request_timeout_args_t* args, size_t* retsize)
+{
+    // The request might hand the CPU straight over to the server
+    pcb_t* client = running;
+
+    k_requestCall(&args->req, retsize);
+
+    if (client->state == BLOCKED) {
+        k_MsgTimeoutStart(args->req.ret_msg->dst, args->ms);
+    }
+}
+
 /**
  * @brief   Performs all operations required to
  *          retrieve the name of the running process.
@@ -371,6 +1111,106 @@ inline void k_setnameCall(char* str)
     if (strlen(str) < 31)   strcpy(running->name, str);
 }
 
+/**
+ * @brief   Performs all operations required to
+ *          set the time quantum of the running process.
+ * @param   [in] quantum:
+ *              Pointer to the new quantum in ms.
+ *              0 makes the process use its priority level's default.
+ * @return  The quantum the process will run with from its next time slice.
+ */
+inline uint32_t k_quantumCall(uint32_t* quantum)
+{
+    running->quantum = (*quantum);
+
+    return GetQuantum(running);
+}
+
+/**
+ * @brief   Performs all operations required to put the running process to sleep.
+ * @param   [in] ticks: Pointer to the amount of ticks to sleep for.
+ * @details The process is blocked until its alarm timer expires.
+ *          Sleeping for 0 ticks returns right away.
+ *          For processes with a deadline, going to sleep completes their job.
+ */
+inline void k_sleepCall(uint32_t* ticks)
+{
+    if ((*ticks) != 0) {
+        if (running->deadline != 0) JobComplete(running);
+
+        k_TimerSetup(&running->alarm, &k_TimerWake, running);
+        k_TimerStart(&running->alarm, (*ticks));
+        BlockPCB(running, SLEEPING);
+        PendSV();
+    }
+}
+
+/**
+ * @brief   Performs all operations required to end the job of a periodic process.
+ * @details The process sleeps until its next nominal release, which is kept
+ *          a whole period after the last one so releases don't drift.
+ *          A job that overran its period has its next job released right away.
+ */
+inline void k_waitPeriodCall()
+{
+    if (running->period == 0)   return;
+
+    JobComplete(running);
+
+    running->release += running->period;
+
+    int32_t delta = (int32_t)(running->release - k_GetTime());
+
+    if (delta > 0) {
+        k_TimerSetup(&running->alarm, &k_TimerWake, running);
+        k_TimerStart(&running->alarm, (uint32_t)delta);
+        BlockPCB(running, SLEEPING);
+    }
+    else {
+        // Re-linking places the new job by its new deadline
+        UnlinkPCB(running);
+        ReleaseJob(running);
+        LinkPCB(running, running->priority);
+        running->state = WAITING_TO_RUN;
+    }
+
+    PendSV();
+}
+
+/**
+ * @brief   Performs all operations required to put the running process to sleep
+ *          until an absolute kernel time.
+ * @param   [in] tick: Pointer to the kernel time (in ticks) to wake up at.
+ * @details Returns right away if the time has already passed.
+ *          Since the wake-up time is absolute, periodic processes don't
+ *          accumulate drift from the time spent between releases.
+ */
+inline void k_sleepUntilCall(uint32_t* tick)
+{
+    int32_t delta = (int32_t)((*tick) - k_GetTime());
+
+    if (delta > 0) {
+        uint32_t ticks = (uint32_t)delta;
+        k_sleepCall(&ticks);
+    }
+}
+
+/**
+ * @brief   Performs all operations required to arm a user timer.
+ * @param   [in] args: Set-timer arguments.
+ * @return  ID of the armed timer,
+ *          TIMER_ERR if the box isn't owned by the running process
+ *          or there are no timers available.
+ */
+inline id_t k_setTimerCall(settimer_args_t* args)
+{
+    if (args->box >= BOXID_MAX || msgbox[args->box].owner != running) {
+        return (id_t)TIMER_ERR;
+    }
+
+    return k_UserTimerStart(running, args->box, args->ms, args->period);
+}
+
 /**
  * @brief   Terminates the running process.
  * @details Unbinds all message boxes and de-allocates the process.
@@ -379,6 +1219,13 @@ void k_Terminate()
 {
     // 1. Unlink process from its process queue
     UnlinkPCB(running);
+    k_TimerCancel(&running->alarm);
+    k_TimerCancel(&running->replenish);
+    k_UserTimerCancelAll(running);
+    k_MsgReleaseAll(running);
+    k_ChanCloseAll(running);
+    k_MsgAsyncCancelAll(running);
+    k_MsgTicketCancelAll(running);
 
     // 2. Unbind all message boxes from process
     k_MsgBoxUnbindAll(running);
@@ -387,20 +1234,27 @@ void k_Terminate()
     k_DeallocatePCB(running->id);
 
     // 4. Schedule a new process
+#if TICKLESS_MODE
+    k_TickSync();
+#endif
     running = Schedule();
+    running->state = RUNNING;
     SetPSP((uint32_t)running->sp);
-    running->timer = PROC_RUNTIME;
 
     // 5. Reset the System timer
-    SysTick_Reset();
+    k_StartQuantum();
 }
 
 /**
  * @brief   Generic Idle process used by the kernel.
+ * @details The CPU sleeps until the next interrupt,
+ *          which in tickless mode is the next kernel event.
  */
 void idle()
 {
-    while (1) {}
+    while (1) {
+        WFI();
+    }
 }
 
 
@@ -5,7 +5,7 @@
  * @details This module should not be exposed to user programs.
  * @author  Manuel Burnay
  * @date    2019.10.23 (Created)
- * @date    2019.11.21 (Last Modified)
+ * @date    2026.10.16 (Last Modified)
  */
 
 #ifndef 	K_HANDLERS_H
@@ -20,6 +20,8 @@ inline void kernel_start();
 
 void KernelCall_handler(k_call_t* call);
 
+void k_StartQuantum();
+
 // Kernel calls
 inline pid_t k_pcreateCall(pcreate_args_t* arg);
 inline pid_t getpidCall();
@@ -28,10 +30,34 @@ inline pmbox_t k_bindCall(pmbox_t* box);
 inline pmbox_t k_unbindCall(pmbox_t* box);
 inline pmbox_t k_getboxCall();
 inline void k_sendCall(pmsg_t* msg, size_t* retsize);
+inline void k_trySendCall(pmsg_t* msg, size_t* retsize);
+void k_SendMessage(pmsg_t* msg, size_t* retsize, bool block);
 inline void k_recvCall(pmsg_t* msg, size_t* retsize);
+inline void k_recvAnyCall(recv_any_args_t* args, size_t* retsize);
+inline void k_tryRecvCall(pmsg_t* msg, size_t* retsize);
+inline bool k_sendAsyncCall(send_async_args_t* args);
+inline uint32_t k_sendManyCall(send_many_args_t* args);
+inline void k_recvManyCall(recv_many_args_t* args, uint32_t* retval);
+inline bool k_chanWaitCall(id_t* id);
+inline void k_chanNotifyCall(id_t* id);
+inline uint8_t* k_loanCall(size_t* size);
+inline void k_sendLoanedCall(pmsg_t* msg, size_t* retsize);
+inline void k_recvLoanedCall(pmsg_t* msg, size_t* retsize);
+inline bool k_releaseCall(uint8_t* data);
 inline void k_requestCall(request_args_t* arg, size_t* retsize);
+void k_Handoff(pcb_t* next);
+inline void k_replyWaitCall(reply_wait_args_t* args, size_t* retsize);
+inline uint32_t k_requestAsyncCall(pmsg_t* msg);
+inline void k_waitReplyCall(wait_reply_args_t* args, size_t* retsize);
+inline void k_recvTimeoutCall(recv_timeout_args_t* args, size_t* retsize);
+inline void k_requestTimeoutCall(request_timeout_args_t* args, size_t* retsize);
 inline void k_getnameCall(char* str);
 inline void k_setnameCall(char* str);
+inline uint32_t k_quantumCall(uint32_t* quantum);
+inline void k_sleepCall(uint32_t* ticks);
+inline void k_waitPeriodCall();
+inline void k_sleepUntilCall(uint32_t* tick);
+inline id_t k_setTimerCall(settimer_args_t* args);
 inline void k_Terminate();
 
 void idle();
@@ -5,23 +5,54 @@
  *          supporting functionality regarding IPC via messages.
  * @author  Manuel Burnay
  * @date    2019.11.18 (Created)
- * @date    2019.11.29 (Last Modified)
+ * @date    2026.10.16 (Last Modified)
  */
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stddef.h>
 #include "k_messaging.h"
 #include "k_scheduler.h"
+#include "k_timer.h"
+#include "k_processes.h"
 #include "dlist.h"
 #include "k_cpu.h"
 #include "bitmap.h"
 
+/** @brief Gets the message a per-source queue node belongs to. */
+#define SRC_LIST_MSG(node)  ((pmsg_t*)((uint8_t*)(node) - offsetof(pmsg_t, src_list)))
+
 pmsgbox_t   msgbox[BOXID_MAX];
 bitmap_t    available_box[MSGBOX_BITMAP_SIZE];
 
 bitmap_t    available_msg[MSG_BITMAP_SIZE];
-pmsg_t      msg_table[MSG_MAX];
-uint8_t     msg_buffer[MSG_MAX][MSG_MAX_SIZE];
+pmsg_t      msg_table[MSG_MAX];     /// Message headers, grouped by size class.
+uint8_t     msg_pool[MSG_POOL_SIZE];    /// Message buffers, grouped by size class.
+
+const uint32_t msg_class_size[MSG_CLASSES] = {
+    MSG_CLASS0_SIZE, MSG_CLASS1_SIZE, MSG_CLASS2_SIZE, MSG_CLASS3_SIZE
+};
+
+const uint32_t msg_class_count[MSG_CLASSES] = {
+    MSG_CLASS0_COUNT, MSG_CLASS1_COUNT, MSG_CLASS2_COUNT, MSG_CLASS3_COUNT
+};
+
+uint32_t    msg_class_start[MSG_CLASSES+1]; /// First message ID of every class.
+uint8_t*    msg_class_pool[MSG_CLASSES];    /// First buffer of every class.
+uint32_t    msg_class_shift[MSG_CLASSES];   /// Log2 of the buffer size of every class.
+uint32_t    msg_class_used[MSG_CLASSES];    /// Messages of every class in use.
+uint32_t    msg_class_peak[MSG_CLASSES];    /// Most messages of every class in use at once.
+pmsg_t*     msg_free[MSG_CLASSES];          /// Free list of every class, linked through msg->next.
+
+async_op_t  async_op[ASYNC_MAX];   /// Asynchronous send table.
+async_op_t* async_queue;            /// Asynchronous sends still waiting on the message pool.
+
+pmsg_t      msg_ref_table[MSG_REF_MAX];     /// Headers queueing published messages on subscriber boxes.
+pmsg_t*     msg_ref_free;                   /// Free list of the published message headers.
+
+rpc_ticket_t    ticket[TICKET_MAX];     /// Asynchronous request table.
+uint32_t        ticket_seq;             /// Sequence number of the last ticket issued.
+uint32_t        ticket_count;           /// Amount of outstanding tickets.
 
 /**
  * @brief   Initalizes the Messaging Module.
@@ -32,10 +63,52 @@ void k_MsgInit()
 
     ClearBitRange(available_msg, 0, MSG_MAX);
 
-    int i;
-    for(i = 0; i < MSG_MAX; i++) {
-        msg_table[i].id = i;
-        msg_table[i].data = msg_buffer[i];
+    int c, i;
+    uint8_t* buffer = msg_pool;
+
+    msg_class_start[0] = 0;
+
+    for (c = 0; c < MSG_CLASSES; c++) {
+        msg_class_start[c+1] = msg_class_start[c] + msg_class_count[c];
+        msg_class_pool[c] = buffer;
+        msg_class_shift[c] = LowestSet(msg_class_size[c]);
+        msg_class_used[c] = 0;
+        msg_class_peak[c] = 0;
+        msg_free[c] = NULL;
+
+        for (i = msg_class_start[c]; i < msg_class_start[c+1]; i++) {
+            msg_table[i].id = i;
+            msg_table[i].data = buffer;
+            buffer += msg_class_size[c];
+        }
+
+        // Lowest IDs end up at the head of the free list
+        for (i = msg_class_start[c+1]; i > msg_class_start[c]; i--) {
+            msg_table[i-1].next = msg_free[c];
+            msg_free[c] = &msg_table[i-1];
+        }
+    }
+
+    msg_ref_free = NULL;
+    async_queue = NULL;
+
+    for (i = 0; i < ASYNC_MAX; i++) {
+        async_op[i].owner = NULL;
+    }
+
+    ticket_seq = 0;
+    ticket_count = 0;
+
+    for (i = 0; i < TICKET_MAX; i++) {
+        ticket[i].id = TICKET_NONE;
+        ticket[i].reply = NULL;
+    }
+
+    for (i = MSG_REF_MAX; i > 0; i--) {
+        msg_ref_table[i-1].id = MSG_MAX + i-1;
+        msg_ref_table[i-1].shared = NULL;
+        msg_ref_table[i-1].next = msg_ref_free;
+        msg_ref_free = &msg_ref_table[i-1];
     }
 
     return;
@@ -56,6 +129,7 @@ pmbox_t k_MsgBoxBind(pmbox_t id, pcb_t* owner)
     if (id < BOXID_MAX && msgbox[id].owner == NULL) {
         // Set the box's owner
         msgbox[id].owner = owner;
+        msgbox[id].depth_max = MSGBOX_DEPTH;
 
         SetBit(available_box, id);
         SetBit(owner->owned_box, id);
@@ -78,10 +152,21 @@ pmbox_t k_MsgBoxUnbind(pmbox_t id, pcb_t* proc)
 {
     pmsgbox_t* box = &msgbox[id];
 
+    int t;
+
     if (id < BOXID_MAX && box->owner == proc) {
         k_MsgClearAll(box);
+        k_UserTimerCancelBox(id);
+        k_MsgSendRelease(box);
+        box->depth_max = 0;
+
+        // Topics drop their subscribers, and the box leaves the topics it subscribed to
+        box->topic = false;
+        ClearBitRange(box->subscribers, 0, BOXID_MAX);
 
-        // Clear all pending messages
+        for (t = 0; t < BOXID_MAX; t++) {
+            ClearBit(msgbox[t].subscribers, id);
+        }
 
         // Reset the box's ownership
         box->owner = NULL;
@@ -110,27 +195,129 @@ void k_MsgBoxUnbindAll(pcb_t* proc)
     }
 }
 
+/**
+ * @brief   Sets the limit of messages queued on a message box.
+ * @param   [in] id: Box ID.
+ * @param   [in] depth: New limit. 0 for no limit.
+ * @param   [in] proc: Process that owns the box.
+ * @return  True if the limit was set,
+ *          False if the process doesn't own the box.
+ * @details Messages already queued past a lower limit are kept.
+ *          Blocked senders are let in if the new limit has room for them.
+ */
+bool k_MsgBoxSetDepth(pmbox_t id, uint32_t depth, pcb_t* proc)
+{
+    if (id >= BOXID_MAX || msgbox[id].owner != proc)    return false;
+
+    msgbox[id].depth_max = depth;
+    k_MsgSendAdmit(&msgbox[id]);
+
+    return true;
+}
+
+/**
+ * @brief   Binds a message box to a process as a topic.
+ * @param   [in] id: Box ID of the topic. ANY_BOX for any available box.
+ * @param   [in,out] proc: Process publishing on the topic.
+ * @return  Box ID of the topic.
+ *          BOX_ERR if it wasn't possible to bind the box.
+ * @details Messages sent to a topic aren't queued on it,
+ *          they are published to every box subscribed to it.
+ */
+pmbox_t k_MsgTopicBind(pmbox_t id, pcb_t* proc)
+{
+    id = k_MsgBoxBind(id, proc);
+
+    if (id < BOXID_MAX) msgbox[id].topic = true;
+
+    return id;
+}
+
+/**
+ * @brief   Subscribes a message box to a topic.
+ * @param   [in] topic: Box ID of the topic.
+ * @param   [in] box: Box ID of the subscriber box.
+ * @param   [in] proc: Process that owns the subscriber box.
+ * @return  True if the box was subscribed,
+ *          False otherwise.
+ * @details Topics can't subscribe to other topics.
+ */
+bool k_MsgSubscribe(pmbox_t topic, pmbox_t box, pcb_t* proc)
+{
+    if (topic >= BOXID_MAX || !msgbox[topic].topic ||
+            box >= BOXID_MAX || msgbox[box].owner != proc || msgbox[box].topic) {
+        return false;
+    }
+
+    SetBit(msgbox[topic].subscribers, box);
+
+    return true;
+}
+
+/**
+ * @brief   Unsubscribes a message box from a topic.
+ * @param   [in] topic: Box ID of the topic.
+ * @param   [in] box: Box ID of the subscriber box.
+ * @param   [in] proc: Process that owns the subscriber box.
+ * @return  True if the box was unsubscribed,
+ *          False if it wasn't subscribed to the topic.
+ */
+bool k_MsgUnsubscribe(pmbox_t topic, pmbox_t box, pcb_t* proc)
+{
+    if (topic >= BOXID_MAX || box >= BOXID_MAX || msgbox[box].owner != proc ||
+            !GetBit(msgbox[topic].subscribers, box)) {
+        return false;
+    }
+
+    ClearBit(msgbox[topic].subscribers, box);
+
+    return true;
+}
+
 /**
  * @brief   Allocates message from available allocatable messages.
+ * @param   [in] size: Size of the message that'll be held (in Bytes).
  * @return  Allocated message if the allocation was successful,
  *          NULL if it was unsuccessful.
+ * @details The message comes from the smallest size class that fits,
+ *          or the next larger class with a free message.
+ *          Its size is set to its buffer's capacity.
+ *          Messages larger than the largest class get the largest class,
+ *          and are truncated to it.
+ *          Free messages are kept in per-class free lists,
+ *          so allocation time doesn't depend on pool occupancy.
  */
-inline pmsg_t* k_pMsgAllocate()
+inline pmsg_t* k_pMsgAllocate(size_t size)
 {
     pmsg_t* msg = NULL;
 
-    uint32_t i = FindClear(available_msg, 0, MSG_MAX);
+    uint32_t c = 0;
 
-    if (i >= MSG_MAX)   return NULL;
+    while (c < MSG_CLASSES-1 && msg_class_size[c] < size)  c++;
 
-    msg = &msg_table[i];
-    SetBit(available_msg, i);
+    while (c < MSG_CLASSES && msg_free[c] == NULL)  c++;
+
+    if (c >= MSG_CLASSES)   return NULL;
+
+    msg = msg_free[c];
+    msg_free[c] = msg->next;
+    SetBit(available_msg, msg->id);
+
+    msg_class_used[c]++;
+    if (msg_class_used[c] > msg_class_peak[c])  msg_class_peak[c] = msg_class_used[c];
 
     msg->list.next = NULL;
     msg->list.prev = NULL;
+    msg->src_list.next = NULL;
+    msg->src_list.prev = NULL;
     msg->dst = ANY_BOX;
     msg->src = ANY_BOX;
-    msg->size = MSG_MAX_SIZE;
+    msg->size = msg_class_size[c];
+    msg->flags = MSG_OWN_KERNEL;
+    msg->refs = 0;
+    msg->shared = NULL;
+    msg->corr = TICKET_NONE;
+    msg->prio = 0;
 
     return msg;
 }
@@ -141,193 +328,1366 @@ inline pmsg_t* k_pMsgAllocate()
  */
 inline void k_pMsgDeallocate(pmsg_t** msg)
 {
+    pmsg_t* payload = (*msg)->shared;
+    uint32_t c;
+
+    if (payload != NULL) {
+        // Header of a published message, which goes once no subscriber holds it
+        k_pMsgShareFree(*msg);
+        *msg = NULL;
+
+        payload->refs--;
+        if (payload->refs == 0) k_pMsgDeallocate(&payload);
+
+        return;
+    }
+
+    c = k_pMsgClass((*msg)->id);
+
     ClearBit(available_msg, (*msg)->id);
+    msg_class_used[c]--;
+
+    (*msg)->next = msg_free[c];
+    msg_free[c] = *msg;
     *msg = NULL;
 }
 
 /**
- * @brief   Sends a message from one process to another.
- * @param   [in] msg: Message to be sent to a process.
+ * @brief   Allocates a header that queues a published message on a subscriber box.
+ * @param   [in,out] payload: Pool message holding the published message.
+ * @return  Header referencing the payload,
+ *          NULL if no header is available.
+ */
+inline pmsg_t* k_pMsgShare(pmsg_t* payload)
+{
+    pmsg_t* ref = msg_ref_free;
+
+    if (ref == NULL)    return NULL;
+
+    msg_ref_free = ref->next;
+
+    ref->list.next = NULL;
+    ref->list.prev = NULL;
+    ref->src_list.next = NULL;
+    ref->src_list.prev = NULL;
+    ref->src = payload->src;
+    ref->dst = payload->dst;
+    ref->size = payload->size;
+    ref->data = payload->data;
+    ref->flags = MSG_OWN_KERNEL;
+    ref->shared = payload;
+    ref->corr = payload->corr;
+    ref->prio = payload->prio;
+
+    payload->refs++;
+
+    return ref;
+}
+
+/**
+ * @brief   Returns a published message header to its free list.
+ * @param   [in,out] ref: Header to free. Its payload is left untouched.
+ */
+inline void k_pMsgShareFree(pmsg_t* ref)
+{
+    ref->shared = NULL;
+    ref->next = msg_ref_free;
+    msg_ref_free = ref;
+}
+
+/**
+ * @brief   Turns a dequeued published message header into a message of its own.
+ * @param   [in,out] ref: Header of the published message. It gets freed.
+ * @param   [in] copy: Private copy of the message,
+ *                     or NULL if ref holds the last reference to its payload.
+ * @return  Pool message holding the message.
+ * @details Used to lend published messages to receivers,
+ *          who are then free to release the buffer they got.
+ */
+inline pmsg_t* k_pMsgUnshare(pmsg_t* ref, pmsg_t* copy)
+{
+    pmsg_t* payload = ref->shared;
+
+    if (copy != NULL) {
+        k_pMsgDeallocate(&ref);
+        return copy;
+    }
+
+    // Last reference, so the payload itself is handed over
+    payload->refs = 0;
+    payload->src = ref->src;
+    payload->dst = ref->dst;
+
+    k_pMsgShareFree(ref);
+
+    return payload;
+}
+
+/**
+ * @brief   Gets the size class of a message.
+ * @param   [in] id: ID of the message.
+ * @return  Size class the message belongs to.
+ */
+inline uint32_t k_pMsgClass(id_t id)
+{
+    uint32_t c = 0;
+
+    while (id >= msg_class_start[c+1])  c++;
+
+    return c;
+}
+
+/**
+ * @brief   Gets the configuration and occupancy of a message size class.
+ * @param   [in] cls: Size class.
+ * @param   [out] size: Buffer size of the class' messages.
+ * @param   [out] count: Amount of messages in the class.
+ * @param   [out] used: Messages of the class currently allocated.
+ * @param   [out] peak: Most messages of the class allocated at once.
+ */
+void k_MsgClassUsage(uint32_t cls, uint32_t* size, uint32_t* count,
+                     uint32_t* used, uint32_t* peak)
+{
+    *size = msg_class_size[cls];
+    *count = msg_class_count[cls];
+    *used = msg_class_used[cls];
+    *peak = msg_class_peak[cls];
+}
+
+/**
+ * @brief   Delivers a message to a message box.
+ * @param   [in] msg: Message to be delivered.
  * @param   [out] retsize: Amount of bytes successfully sent to message box.
- * @details If a message was sent to a process that was awaiting the message,
- *          then this function places that process back into its scheduling queue
- *          and calls the scheduler trap to re-evaluate the running process.
+ * @return  Pointer to the PCB of the receiver if it was awaiting the message
+ *          (and was placed back into its scheduling queue),
+ *          NULL if the message was queued instead.
+ * @details A waiting receiver gets the message copied straight into its
+ *          message slot. This function doesn't call the scheduler,
+ *          so the caller decides how the receiver gets to run.
+ *          A message loaned from the pool is queued or lent to the receiver
+ *          as-is, without copying its contents. A borrowing receiver is left
+ *          waiting if no pool message is free to copy the message into.
  */
-void k_MsgSend(pmsg_t* msg, size_t* retsize)
+pcb_t* k_MsgDeliver(pmsg_t* msg, size_t* retsize)
 {
     size_t size = 0;
 
     pmsg_t* msg_out;
 
+    pcb_t* receiver = NULL;
+
     pmsgbox_t* dst_box = &msgbox[msg->dst];
 
-    bool wait_msg_good =
-            dst_box->wait_msg != NULL && (dst_box->wait_msg->src == ANY_BOX ||
-                    dst_box->wait_msg->src == msg->src);
+    bool pooled = (msg->flags == MSG_OWN_LOANED);
+
+    rpc_ticket_t* t;
 
-    if (wait_msg_good) {
-        size = k_pMsgTransfer(dst_box->wait_msg, msg);
+    if (msg->prio >= MSG_PRIORITIES)    msg->prio = MSG_PRIORITIES-1;
+
+    if (ticket_count > 0) {
+        // Replies to asynchronous requests go to their ticket instead of the box
+        if (msg->corr == TICKET_NONE)   msg->corr = k_MsgTicketMatch(msg->dst, msg->src);
+
+        t = k_MsgTicketLookup(msg->corr);
+
+        if (t != NULL && t->reply == NULL &&
+                t->client_box == msg->dst && t->server_box == msg->src) {
+            return k_MsgReply(t, msg, retsize);
+        }
+    }
+
+    if (dst_box->topic) return k_MsgPublish(msg, retsize);
+
+    if (k_MsgAwaited(dst_box, msg->src)) {
+        if (dst_box->wait_msg->flags == MSG_OWN_BORROW) {
+            // Receiver reads the message in place
+            msg_out = (pooled) ? msg : k_pMsgCopy(msg);
+
+            // Out of pool messages: the receiver keeps waiting, the sender gets 0
+            if (msg_out == NULL) {
+                if (retsize != NULL)    *retsize = 0;
+                return NULL;
+            }
+
+            size = k_pMsgLend(dst_box->wait_msg, msg_out, dst_box->owner);
+        }
+        else {
+            size = k_pMsgTransfer(dst_box->wait_msg, msg);
+
+            if (pooled) k_MsgRelease(msg);
+        }
+
+        // Tells receivers waiting on several boxes where the message came in
+        dst_box->wait_msg->dst = msg->dst;
 
         // Remove link from the Receiver's box
         if (dst_box->retsize != NULL)   *dst_box->retsize = size;
         dst_box->wait_msg = NULL;
+        dst_box->retsize = NULL;
 
-        LinkPCB(dst_box->owner, dst_box->owner->priority);
+        receiver = dst_box->owner;
 
-        PendSV();
+        // Receiver might be waiting with a timeout, on a reply, or on other boxes
+        k_MsgWaitCancel(receiver);
+        k_TimerCancel(&receiver->alarm);
+        WakePCB(receiver);
+        k_MsgRequestEnd(receiver);
     }
     else {
-        // Allocate Message
-        msg_out = k_pMsgAllocate();
-        size = k_pMsgTransfer(msg_out, msg);
+        // Loaned messages are queued as they are, others are copied to the pool
+        msg_out = (pooled) ? msg : k_pMsgCopy(msg);
 
         // Send if message allocation was successful
         if (msg_out != NULL) {
-            if (msgbox[msg->dst].recv_msgq == NULL) {
-                msgbox[msg->dst].recv_msgq = msg_out;
-            }
+            msg_out->flags = MSG_OWN_KERNEL;
 
-            dLink(&msg_out->list, &msgbox[msg->dst].recv_msgq->list);
+            k_MsgEnqueue(dst_box, msg_out);
 
             size = msg_out->size;
         }
     }
 
     if (retsize != NULL)    *retsize = size;
+
+    return receiver;
 }
 
 /**
- * @brief   Recieves a message from a process to another.
- * @param   [in,out] dst_msg:
- *              Pointer to the receiver's message slot.
- *              A message that is awaiting to be received will be copied here.
- * @param   [out] retsize: Number of bytes successfully received.
- * @details If there isn't any messages to receive,
- *          the dst_msg and retsize's addresses are copied onto the receiver's
- *          message box and the process that owns the message box is then blocked
- *          while it awaits for another process to send it a message.
+ * @brief   Checks if a message box' owner is blocked on a message from a source.
+ * @param   [in] box: Message box to check.
+ * @param   [in] src: Source box of the message.
+ * @return  True if a message from src would be handed straight to the receiver.
  */
-void k_MsgRecv(pmsg_t* msg, size_t* retsize)
+inline bool k_MsgAwaited(pmsgbox_t* box, pmbox_t src)
 {
-    pmsgbox_t* dst_box = NULL;
+    return box->wait_msg != NULL &&
+            (box->wait_msg->src == ANY_BOX || box->wait_msg->src == src);
+}
 
-    pmsg_t* src_msg = NULL;
+/**
+ * @brief   Publishes a message sent to a topic to all its subscribers.
+ * @param   [in] msg: Message sent to the topic.
+ * @param   [out] retsize: Size of the published message,
+ *                         0 if no subscriber got it.
+ * @return  Pointer to the PCB of the highest priority subscriber that
+ *          was awaiting the message, NULL if none was.
+ * @details Waiting subscribers get the message copied straight into their slot.
+ *          For all others the message is stored once in the pool,
+ *          and every subscriber queue gets a header referencing it.
+ *          The stored message is freed when the last subscriber receives it.
+ *          A message loaned from the pool is stored as it is.
+ */
+pcb_t* k_MsgPublish(pmsg_t* msg, size_t* retsize)
+{
+    pmsgbox_t* topic = &msgbox[msg->dst];
 
-    (*retsize) = 0;
+    pmsg_t view = *msg;
+    pmsg_t* payload = NULL;
+    pmsg_t* ref;
 
-    // If no errors were found
-    dst_box = &msgbox[msg->dst];
+    pcb_t* receiver;
+    pcb_t* woken = NULL;
 
-    if (dst_box->recv_msgq == NULL) {
-        // No messages to receive at the time.
-        // Link Rx message onto message box
-        dst_box->wait_msg = msg;
-        dst_box->retsize = retsize;
-        UnlinkPCB(dst_box->owner);
-        dst_box->owner->state = BLOCKED;
-        PendSV();
-    }
-    else if (msg->src == ANY_BOX || dst_box->recv_msgq->src == msg->src) {
-        src_msg = dst_box->recv_msgq;
+    bool pooled = (msg->flags == MSG_OWN_LOANED);
+    size_t size, published = 0;
 
-        dst_box->recv_msgq = dst_box->recv_msgq->next;
+    uint32_t box = FindSet(topic->subscribers, 0, BOXID_MAX);
 
-        if (dst_box->recv_msgq == src_msg) {
-            dst_box->recv_msgq = NULL;
-        }
+    // Waiting subscribers are sent copies of the message, never the loaned buffer
+    view.flags = MSG_OWN_KERNEL;
 
-        dUnlink(&src_msg->list);
+    while (box < BOXID_MAX) {
+        view.dst = box;
 
-        (*retsize) = k_pMsgTransfer(msg, src_msg);
-        k_pMsgDeallocate(&src_msg);
-    }
-    else {
-        // Search Recv queue for specific message box source
-        src_msg = k_SearchMessageList(dst_box->recv_msgq, msg->src);
-
-        if (src_msg == NULL) {
-            // If message was not found
-            // Link Rx message onto message box
-            dst_box->wait_msg = msg;
-            dst_box->retsize = retsize;
-            UnlinkPCB(dst_box->owner);
-            dst_box->owner->state = BLOCKED;
-            PendSV();
+        // A delivery can tag the message as a reply, so every subscriber starts clean
+        view.corr = TICKET_NONE;
+
+        if (k_MsgAwaited(&msgbox[box], msg->src)) {
+            receiver = k_MsgDeliver(&view, &size);
+
+            if (receiver != NULL &&
+                    (woken == NULL || receiver->priority < woken->priority)) {
+                woken = receiver;
+            }
         }
         else {
-            // Message was found
-            // Unlink it from Recv queue
-            dUnlink(&src_msg->list);
+            if (payload == NULL)    payload = (pooled) ? msg : k_pMsgCopy(msg);
+
+            ref = (payload != NULL) ? k_pMsgShare(payload) : NULL;
+
+            if (ref != NULL) {
+                ref->dst = box;
+                k_MsgEnqueue(&msgbox[box], ref);
+            }
 
-            // Transfer message
-            (*retsize) = k_pMsgTransfer(msg, src_msg);
-            k_pMsgDeallocate(&src_msg);
+            size = (ref != NULL) ? ref->size : 0;
         }
+
+        if (size != 0)  published = msg->size;
+
+        box = FindSet(topic->subscribers, box+1, BOXID_MAX);
+    }
+
+    // Loaned buffer is given back to the kernel even if no queue holds it
+    if (pooled && payload == NULL)  payload = msg;
+
+    if (payload != NULL) {
+        payload->flags = MSG_OWN_KERNEL;
+        if (payload->refs == 0) k_pMsgDeallocate(&payload);
     }
+
+    if (retsize != NULL)    *retsize = published;
+
+    return woken;
 }
 
 /**
- * @brief   Transfers a message to another.
- * @param   [in,out] dst: Pointer to message that will be overwritten
- * @param   [in] src: Pointer to src message whose contents will be copied.
- * @return  Amount of bytes successfully transfered from one message to another.
- * @details If the destination doesn't have a valid data pointer,
- *          data won't be transfered, but the size of the "would-be" transfer is
- *          still recorded.
- *          This allows for messages that just want the size of the message
- *          to be possible.
+ * @brief   Sends a message from one process to another.
+ * @param   [in] msg: Message to be sent to a process.
+ * @param   [out] retsize: Amount of bytes successfully sent to message box.
+ * @details If a message was sent to a process that was awaiting the message,
+ *          then this function places that process back into its scheduling queue
+ *          and calls the scheduler trap to re-evaluate the running process.
+ *          Used by the kernel and drivers, which can't block,
+ *          so the box' queue limit doesn't apply.
  */
-inline uint32_t k_pMsgTransfer(pmsg_t* dst, pmsg_t* src)
+void k_MsgSend(pmsg_t* msg, size_t* retsize)
 {
-    // Truncate if not enough space in dst
-    if (dst->size > src->size)   dst->size = src->size;
-    if (dst->data != NULL && src->data != NULL) {
-        memcpy(dst->data, src->data, dst->size);
+    if (k_MsgDeliver(msg, retsize) != NULL) {
+        PendSV();
     }
-    dst->src = src->src;
+}
 
-    return dst->size;
+/**
+ * @brief   Checks if a message can be sent without overflowing its box' queue.
+ * @param   [in] msg: Message to send.
+ * @return  True if the box has room for the message, or the message
+ *          doesn't get queued on it (waiting receiver, topic or request ticket).
+ * @details Senders that are already blocked on the box keep their place,
+ *          so a box with blocked senders has no room for new ones.
+ */
+bool k_MsgAdmitted(pmsg_t* msg)
+{
+    pmsgbox_t* box = &msgbox[msg->dst];
+    rpc_ticket_t* t;
+
+    if (box->depth_max == 0 || box->topic ||
+            (box->depth < box->depth_max && box->send_q == NULL)) {
+        return true;
+    }
+
+    if (k_MsgAwaited(box, msg->src))    return true;
+
+    if (ticket_count == 0)  return false;
+
+    // Replies to asynchronous requests are held by their ticket
+    t = k_MsgTicketLookup((msg->corr != TICKET_NONE) ?
+            msg->corr : k_MsgTicketMatch(msg->dst, msg->src));
+
+    return t != NULL && t->reply == NULL &&
+            t->client_box == msg->dst && t->server_box == msg->src;
 }
 
 /**
- * @brief   Clears all Messages currently in the message box.
- * @param   [in,out] box: Message box to clear messages from.
+ * @brief   Blocks a process until there is room for its message in a box' queue.
+ * @param   [in] msg: Message to send. Has to stay valid while the process is blocked.
+ * @param   [out] retsize: Amount of bytes successfully sent.
+ * @param   [in,out] proc: Process to block.
+ * @details The process is queued behind the senders already blocked on the box.
+ *          This function doesn't call the scheduler.
  */
-void k_MsgClearAll(pmsgbox_t* box)
+void k_MsgSendWait(pmsg_t* msg, size_t* retsize, pcb_t* proc)
 {
-    pmsg_t* msg;
+    pmsgbox_t* box = &msgbox[msg->dst];
+
+    (*retsize) = 0;
 
-    while (box->recv_msgq != NULL) {
-        msg = box->recv_msgq;
-        box->recv_msgq = box->recv_msgq->next;
+    proc->send_msg = msg;
+    proc->send_size = retsize;
+    BlockPCB(proc, BLOCKED);
 
-        if (msg == box->recv_msgq)  box->recv_msgq = NULL;
+    proc->list.next = NULL;
+    proc->list.prev = NULL;
 
-        k_pMsgDeallocate(&msg);
+    if (box->send_q == NULL)    box->send_q = proc;
+    dLink(&proc->list, &box->send_q->list);
+}
+
+/**
+ * @brief   Sends the messages of blocked senders that a box can take in.
+ * @param   [in,out] box: Message box with blocked senders.
+ * @details Senders are let in in the order they blocked while the box has room.
+ *          A sender whose message the box' owner is waiting on is let in
+ *          regardless. Woken senders are scheduled by the scheduler trap.
+ */
+void k_MsgSendAdmit(pmsgbox_t* box)
+{
+    pcb_t* sender = box->send_q;
+    pcb_t* next;
+
+    while (sender != NULL) {
+        next = (sender->next == box->send_q) ? NULL : sender->next;
+
+        if (box->depth_max == 0 || box->depth < box->depth_max ||
+                k_MsgAwaited(box, sender->send_msg->src)) {
+            if (box->send_q == sender) {
+                box->send_q = (sender->next == sender) ? NULL : sender->next;
+            }
+            dUnlink(&sender->list);
+
+            k_MsgDeliver(sender->send_msg, sender->send_size);
+
+            sender->send_msg = NULL;
+            sender->send_size = NULL;
+            WakePCB(sender);
+            PendSV();
+        }
+
+        sender = next;
+    }
+}
+
+/**
+ * @brief   Wakes up all the senders blocked on a box, without sending their messages.
+ * @param   [in,out] box: Message box that is going away.
+ */
+void k_MsgSendRelease(pmsgbox_t* box)
+{
+    pcb_t* sender;
+
+    while (box->send_q != NULL) {
+        sender = box->send_q;
+        box->send_q = (sender->next == sender) ? NULL : sender->next;
+        dUnlink(&sender->list);
+
+        *sender->send_size = 0;
+        sender->send_msg = NULL;
+        sender->send_size = NULL;
+        WakePCB(sender);
+        PendSV();
     }
 }
 
 /**
- * @brief   Searches through message list for a message with a particular
- *          message box as its source.
- * @param   [in] msg: pointer to message list entry point.
- * @param   [in] box: box ID to search message's source for.
- * @return  pointer to message whose source has a matching box ID.
- *          NULL if no messages in message list has a source matching the box ID.
+ * @brief   Registers a client as blocked on a request to a box.
+ * @param   [in,out] client: Pointer to the PCB of the blocked client.
+ * @param   [in] id: Box the request was sent to.
+ * @details The owner of the box inherits the client's priority
+ *          until the client gets its reply.
  */
-pmsg_t* k_SearchMessageList(pmsg_t* msg, pmbox_t box)
+void k_MsgRequestStart(pcb_t* client, pmbox_t id)
 {
-    pmsg_t* search;
+    client->req_box = id;
+    client->lent_priority = IsEDF(client) ? HIGH_PRIORITY : client->priority;
+    k_MsgBoxLend(id, client->lent_priority);
+
+    if (msgbox[id].owner != NULL)   UpdatePriority(msgbox[id].owner);
+}
 
-    if (msg == NULL)    return NULL;
-    if (msg->src == box) return msg;
+/**
+ * @brief   Ends a client's request, if it had one pending.
+ * @param   [in,out] client: Pointer to the PCB of the client.
+ * @details The owner of the box the request was sent to
+ *          gives up the priority it inherited from the client.
+ */
+void k_MsgRequestEnd(pcb_t* client)
+{
+    pmbox_t id = client->req_box;
 
-    search = msg->next;
+    if (id < BOXID_MAX) {
+        client->req_box = BOXID_MAX;
+        k_MsgBoxUnlend(id, client->lent_priority);
 
-    while (search != msg) {
-        if (search->src == box) return search;
-        else search = search->next;
+        if (msgbox[id].owner != NULL)   UpdatePriority(msgbox[id].owner);
     }
+}
 
-    return NULL;
+/**
+ * @brief   Records a priority lent to the owner of a box by a blocked client.
+ * @param   [in] id: Box the client is blocked on a request to.
+ * @param   [in] priority: Priority the client lends.
+ */
+inline void k_MsgBoxLend(pmbox_t id, priority_t priority)
+{
+    if (msgbox[id].lent[priority]++ == 0)   SetBit(msgbox[id].lent_levels, priority);
+}
+
+/**
+ * @brief   Takes back a priority lent to the owner of a box.
+ * @param   [in] id: Box the client was blocked on a request to.
+ * @param   [in] priority: Priority the client lent.
+ */
+inline void k_MsgBoxUnlend(pmbox_t id, priority_t priority)
+{
+    if (--msgbox[id].lent[priority] == 0)   ClearBit(msgbox[id].lent_levels, priority);
+}
+
+/**
+ * @brief   Gets the highest priority lent to the owner of a box.
+ * @param   [in] id: Box ID.
+ * @return  Highest lent priority,
+ *          PRIORITY_LEVELS if no client is blocked on a request to the box.
+ */
+inline priority_t k_MsgBoxBoost(pmbox_t id)
+{
+    return FindSet(msgbox[id].lent_levels, 0, PRIORITY_LEVELS);
+}
+
+/**
+ * @brief   Limits how long the owner of a box waits on its pending receive.
+ * @param   [in] id: Box with a pending receive.
+ * @param   [in] ticks: Amount of ticks to wait for before timing out.
+ * @details Uses the owner's alarm timer, as a blocked process can't be sleeping.
+ */
+void k_MsgTimeoutStart(pmbox_t id, uint32_t ticks)
+{
+    pcb_t* owner = msgbox[id].owner;
+
+    k_TimerSetup(&owner->alarm, &k_MsgTimeout, &msgbox[id]);
+    k_TimerStart(&owner->alarm, ticks);
+}
+
+/**
+ * @brief   Timer expire function of a receive timeout.
+ * @param   [in] tmr: Alarm timer of the receiver, with its box as argument.
+ * @details The pending receive slot is cleared and MSG_TIMEOUT is returned
+ *          to the receiver, so a message sent afterwards is queued instead.
+ *          If the receiver was waiting on a reply, a dropped ticket is issued for it:
+ *          the late reply is matched to the ticket and discarded,
+ *          instead of being taken by the receiver's next request.
+ */
+void k_MsgTimeout(ktimer_t* tmr)
+{
+    pmsgbox_t* box = (pmsgbox_t*)tmr->arg;
+    pmbox_t server = box->owner->req_box;
+    rpc_ticket_t* t;
+
+    if (box->wait_msg != NULL) {
+        if (server < BOXID_MAX) {
+            t = k_MsgTicketIssue((pmbox_t)(box - msgbox), server, box->owner);
+            if (t != NULL)  t->dropped = true;
+        }
+
+        if (box->retsize != NULL)   *box->retsize = MSG_TIMEOUT;
+        box->wait_msg = NULL;
+        box->retsize = NULL;
+
+        k_MsgWaitCancel(box->owner);
+        WakePCB(box->owner);
+        k_MsgRequestEnd(box->owner);
+    }
+}
+
+/**
+ * @brief   Gets the message a receive would take out of a message box, without taking it.
+ * @param   [in] box: Message box to look into.
+ * @param   [in] src: Source box of the message. ANY_BOX for any source.
+ * @return  Pointer to the oldest matching queued message,
+ *          NULL if none is queued.
+ */
+pmsg_t* k_MsgPeek(pmbox_t box, pmbox_t src)
+{
+    if (box >= BOXID_MAX)   return NULL;
+
+    if (src == ANY_BOX)     return k_MsgHead(&msgbox[box]);
+    if (src < BOXID_MAX)    return msgbox[box].src_msgq[src];
+
+    return NULL;
+}
+
+/**
+ * @brief   Starts an asynchronous send.
+ * @param   [in] msg: Message to send. Its data has to stay valid until completion.
+ * @param   [in] notify: Box the completion record is posted to.
+ * @param   [in] tag: Tag copied into the completion record.
+ * @param   [in] proc: Process making the send.
+ * @return  True if the send was taken in,
+ *          False if no asynchronous send entry is available.
+ * @details The message is sent right away if possible. If the message pool
+ *          is out of messages, the send (or the posting of its completion
+ *          record) is queued and retried as messages are freed.
+ *          Queued sends complete in the order they were made.
+ */
+bool k_MsgSendAsync(pmsg_t* msg, pmbox_t notify, uint32_t tag, pcb_t* proc)
+{
+    async_op_t* op = NULL;
+    int i;
+
+    for (i = 0; i < ASYNC_MAX && op == NULL; i++) {
+        if (async_op[i].owner == NULL)  op = &async_op[i];
+    }
+
+    if (op == NULL) return false;
+
+    op->list.next = NULL;
+    op->list.prev = NULL;
+    op->msg = *msg;
+    op->msg.flags = MSG_OWN_KERNEL;
+    op->notify = notify;
+    op->done.tag = tag;
+    op->done.dst = msg->dst;
+    op->done.size = 0;
+    op->sent = false;
+    op->owner = proc;
+
+    // Earlier sends still waiting keep their place ahead of this one
+    if (async_queue != NULL || !k_MsgAsyncStep(op)) {
+        if (async_queue == NULL)    async_queue = op;
+        dLink(&op->list, &async_queue->list);
+    }
+
+    return true;
+}
+
+/**
+ * @brief   Moves an asynchronous send as far as the message pool allows.
+ * @param   [in,out] op: Asynchronous send.
+ * @return  True if the send completed (and its entry was freed),
+ *          False if the pool ran out of messages.
+ * @details Woken receivers are scheduled by the scheduler trap.
+ */
+bool k_MsgAsyncStep(async_op_t* op)
+{
+    size_t size;
+    pmsg_t record = {
+         .dst = op->notify, .src = op->msg.src,
+         .data = (uint8_t*)&op->done, .size = sizeof(async_done_t),
+         .flags = MSG_OWN_KERNEL
+    };
+
+    if (!op->sent) {
+        if (!k_MsgAdmitted(&op->msg))   return false;
+
+        if (k_MsgDeliver(&op->msg, &op->done.size) != NULL) PendSV();
+        if (op->done.size == 0) return false;
+
+        op->sent = true;
+    }
+
+    if (!k_MsgAdmitted(&record))    return false;
+
+    if (k_MsgDeliver(&record, &size) != NULL)   PendSV();
+    if (size == 0)  return false;
+
+    op->owner = NULL;
+
+    return true;
+}
+
+/**
+ * @brief   Retries queued asynchronous sends, in order, until the pool runs out.
+ */
+void k_MsgAsyncRetry()
+{
+    async_op_t* op;
+
+    while (async_queue != NULL) {
+        op = async_queue;
+
+        if (!k_MsgAsyncStep(op))    return;
+
+        async_queue = (op->next == op) ? NULL : op->next;
+        dUnlink(&op->list);
+    }
+}
+
+/**
+ * @brief   Checks if asynchronous sends are waiting on the message pool.
+ * @return  True if any asynchronous send is queued.
+ */
+inline bool k_MsgAsyncPending()
+{
+    return (async_queue != NULL);
+}
+
+/**
+ * @brief   Drops all the asynchronous sends of a process.
+ * @param   [in] proc: Process whose sends are dropped.
+ */
+void k_MsgAsyncCancelAll(pcb_t* proc)
+{
+    async_op_t* op;
+    int i;
+
+    for (i = 0; i < ASYNC_MAX; i++) {
+        op = &async_op[i];
+
+        if (op->owner != proc)  continue;
+
+        if (op->list.next != NULL) {
+            if (async_queue == op)  async_queue = (op->next == op) ? NULL : op->next;
+            dUnlink(&op->list);
+        }
+
+        op->owner = NULL;
+    }
+}
+
+/**
+ * @brief   Issues a ticket for an asynchronous request.
+ * @param   [in] client_box: Box the request is sent from.
+ * @param   [in] server_box: Box the request is sent to.
+ * @param   [in] proc: Process making the request.
+ * @return  Issued ticket,
+ *          NULL if too many requests are outstanding.
+ */
+rpc_ticket_t* k_MsgTicketIssue(pmbox_t client_box, pmbox_t server_box, pcb_t* proc)
+{
+    rpc_ticket_t* t = NULL;
+    uint32_t i;
+
+    for (i = 0; i < TICKET_MAX && t == NULL; i++) {
+        if (ticket[i].id == TICKET_NONE)    t = &ticket[i];
+    }
+
+    if (t == NULL)  return NULL;
+
+    i = (uint32_t)(t - ticket);
+
+    // The entry index lives in the low bits, the sequence number in the rest
+    do {
+        ticket_seq++;
+        t->id = ticket_seq*TICKET_MAX + i;
+    } while (t->id == TICKET_NONE || t->id == TICKET_ANY);
+
+    t->client = proc;
+    t->client_box = client_box;
+    t->server_box = server_box;
+    t->reply = NULL;
+    t->dropped = false;
+
+    ticket_count++;
+
+    return t;
+}
+
+/**
+ * @brief   Gets the outstanding ticket with an ID.
+ * @param   [in] id: Ticket ID.
+ * @return  Ticket with the ID,
+ *          NULL if no outstanding ticket has it.
+ */
+inline rpc_ticket_t* k_MsgTicketLookup(uint32_t id)
+{
+    rpc_ticket_t* t = &ticket[id % TICKET_MAX];
+
+    return (id != TICKET_NONE && t->id == id) ? t : NULL;
+}
+
+/**
+ * @brief   Finds the ticket a reply that doesn't carry one belongs to.
+ * @param   [in] client_box: Box the reply is sent to.
+ * @param   [in] server_box: Box the reply is sent from.
+ * @return  ID of the oldest unanswered ticket between the two boxes,
+ *          TICKET_NONE if there is none.
+ * @details Servers reply to their requests in the order they took them in,
+ *          so servers don't have to know about tickets at all.
+ */
+uint32_t k_MsgTicketMatch(pmbox_t client_box, pmbox_t server_box)
+{
+    rpc_ticket_t* oldest = NULL;
+    rpc_ticket_t* t;
+    uint32_t i;
+
+    for (i = 0; i < TICKET_MAX; i++) {
+        t = &ticket[i];
+
+        if (t->id != TICKET_NONE && t->reply == NULL &&
+                t->client_box == client_box && t->server_box == server_box &&
+                (oldest == NULL || (int32_t)(t->id - oldest->id) < 0)) {
+            oldest = t;
+        }
+    }
+
+    return (oldest != NULL) ? oldest->id : TICKET_NONE;
+}
+
+/**
+ * @brief   Returns a ticket to the request table.
+ * @param   [in,out] t: Ticket to free. A reply it still holds is de-allocated.
+ */
+void k_MsgTicketFree(rpc_ticket_t* t)
+{
+    if (t->reply != NULL)   k_pMsgDeallocate(&t->reply);
+
+    t->id = TICKET_NONE;
+    t->client = NULL;
+
+    ticket_count--;
+}
+
+/**
+ * @brief   Frees all the tickets of a process.
+ * @param   [in] proc: Process whose requests are dropped.
+ * @details Replies that arrive for them afterwards are sent to the client box as-is.
+ */
+void k_MsgTicketCancelAll(pcb_t* proc)
+{
+    uint32_t i;
+
+    for (i = 0; i < TICKET_MAX; i++) {
+        if (ticket[i].id != TICKET_NONE && ticket[i].client == proc) {
+            k_MsgTicketFree(&ticket[i]);
+        }
+    }
+
+    proc->wait_ticket = TICKET_NONE;
+}
+
+/**
+ * @brief   Checks if a process can still get a reply on a ticket.
+ * @param   [in] id: Ticket ID. TICKET_ANY for any ticket of the process.
+ * @param   [in] proc: Process that made the request.
+ * @return  True if the ticket (or any, for TICKET_ANY) is outstanding.
+ */
+bool k_MsgTicketHeld(uint32_t id, pcb_t* proc)
+{
+    rpc_ticket_t* t;
+    uint32_t i;
+
+    if (id != TICKET_ANY) {
+        t = k_MsgTicketLookup(id);
+        return (t != NULL && t->client == proc);
+    }
+
+    for (i = 0; i < TICKET_MAX; i++) {
+        if (ticket[i].id != TICKET_NONE && ticket[i].client == proc &&
+                !ticket[i].dropped) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief   Hands a reply to the ticket of its request.
+ * @param   [in,out] t: Ticket of the request.
+ * @param   [in] msg: Reply message.
+ * @param   [out] retsize: Amount of bytes successfully sent.
+ * @return  Pointer to the PCB of the client if it was waiting on the reply
+ *          (and was placed back into its scheduling queue),
+ *          NULL if the reply is held by the ticket instead.
+ * @details The ticket is freed once the client gets the reply.
+ *          The reply to a dropped ticket is discarded, as the client stopped waiting for it.
+ *          This function doesn't call the scheduler.
+ */
+pcb_t* k_MsgReply(rpc_ticket_t* t, pmsg_t* msg, size_t* retsize)
+{
+    pcb_t* client = t->client;
+    pmsg_t* msg_out;
+    size_t size = 0;
+
+    bool pooled = (msg->flags == MSG_OWN_LOANED);
+
+    if (t->dropped) {
+        size = msg->size;
+        client = NULL;
+
+        if (pooled) k_MsgRelease(msg);
+
+        k_MsgTicketFree(t);
+    }
+    else if (client->wait_ticket == t->id || client->wait_ticket == TICKET_ANY) {
+        size = k_pMsgTransfer(client->reply_slot, msg);
+
+        if (pooled) k_MsgRelease(msg);
+
+        *client->reply_size = size;
+        client->wait_ticket = TICKET_NONE;
+        client->reply_slot = NULL;
+        client->reply_size = NULL;
+
+        k_MsgTicketFree(t);
+        WakePCB(client);
+    }
+    else {
+        msg_out = (pooled) ? msg : k_pMsgCopy(msg);
+
+        if (msg_out != NULL) {
+            msg_out->flags = MSG_OWN_KERNEL;
+            t->reply = msg_out;
+
+            size = msg_out->size;
+        }
+
+        client = NULL;
+    }
+
+    if (retsize != NULL)    *retsize = size;
+
+    return client;
+}
+
+/**
+ * @brief   Takes the reply to a request out of its ticket.
+ * @param   [in,out] msg: Pointer to the client's message slot.
+ *                        Its corr is set to the ticket of the reply.
+ * @param   [in] id: Ticket ID. TICKET_ANY for the oldest reply that arrived.
+ * @param   [in] proc: Process that made the request.
+ * @param   [out] retsize: Number of bytes successfully received.
+ * @return  True if a reply was received (and its ticket freed),
+ *          False if no reply to the ticket arrived yet.
+ */
+bool k_MsgFetchReply(pmsg_t* msg, uint32_t id, pcb_t* proc, size_t* retsize)
+{
+    rpc_ticket_t* t = NULL;
+    uint32_t i;
+
+    (*retsize) = 0;
+
+    if (id != TICKET_ANY) {
+        t = k_MsgTicketLookup(id);
+        if (t != NULL && (t->client != proc || t->reply == NULL))  t = NULL;
+    }
+    else {
+        for (i = 0; i < TICKET_MAX; i++) {
+            if (ticket[i].id != TICKET_NONE && ticket[i].client == proc &&
+                    ticket[i].reply != NULL &&
+                    (t == NULL || (int32_t)(ticket[i].id - t->id) < 0)) {
+                t = &ticket[i];
+            }
+        }
+    }
+
+    if (t == NULL)  return false;
+
+    (*retsize) = k_pMsgTransfer(msg, t->reply);
+    k_MsgTicketFree(t);
+
+    return true;
+}
+
+/**
+ * @brief   Blocks a process until the reply to a request arrives.
+ * @param   [in,out] msg: Pointer to the client's message slot.
+ * @param   [in] id: Ticket ID. TICKET_ANY for the first reply to arrive.
+ * @param   [out] retsize: Number of bytes successfully received.
+ * @param   [in,out] proc: Process to block.
+ * @details This function doesn't call the scheduler.
+ */
+void k_MsgWaitReply(pmsg_t* msg, uint32_t id, size_t* retsize, pcb_t* proc)
+{
+    (*retsize) = 0;
+
+    proc->wait_ticket = id;
+    proc->reply_slot = msg;
+    proc->reply_size = retsize;
+    BlockPCB(proc, BLOCKED);
+}
+
+/**
+ * @brief   Takes a message out of a message box's receive queue.
+ * @param   [in,out] msg:
+ *              Pointer to the receiver's message slot.
+ *              A queued message that matches its source will be copied here.
+ * @param   [out] retsize: Number of bytes successfully received.
+ * @return  True if a message was received,
+ *          False if no queued message matched.
+ */
+bool k_MsgFetch(pmsg_t* msg, size_t* retsize)
+{
+    pmsgbox_t* dst_box = &msgbox[msg->dst];
+
+    pmsg_t* src_msg = NULL;
+    pmsg_t* copy = NULL;
+
+    (*retsize) = 0;
+
+    if (msg->src == ANY_BOX) {
+        src_msg = k_MsgHead(dst_box);
+    }
+    else if (msg->src < BOXID_MAX) {
+        // Oldest message from the specific message box source
+        src_msg = dst_box->src_msgq[msg->src];
+    }
+
+    if (src_msg == NULL)    return false;
+
+    if (msg->flags == MSG_OWN_BORROW && src_msg->shared != NULL &&
+            src_msg->shared->refs > 1) {
+        // Other subscribers still need the published buffer, so this one gets a copy
+        copy = k_pMsgCopy(src_msg);
+
+        if (copy == NULL)   return false;
+    }
+
+    // Unlink it from Recv queue and transfer message
+    k_MsgDequeue(dst_box, src_msg);
+
+    if (msg->flags == MSG_OWN_BORROW) {
+        if (src_msg->shared != NULL)    src_msg = k_pMsgUnshare(src_msg, copy);
+
+        (*retsize) = k_pMsgLend(msg, src_msg, dst_box->owner);
+    }
+    else {
+        (*retsize) = k_pMsgTransfer(msg, src_msg);
+        k_pMsgDeallocate(&src_msg);
+    }
+
+    // Room was made for a blocked sender
+    if (dst_box->send_q != NULL)    k_MsgSendAdmit(dst_box);
+
+    return true;
+}
+
+/**
+ * @brief   Blocks the owner of a message box until a message arrives.
+ * @param   [in,out] msg: Pointer to the receiver's message slot.
+ * @param   [out] retsize: Number of bytes successfully received.
+ * @details The dst_msg and retsize's addresses are copied onto the receiver's
+ *          message box and the process that owns the message box is blocked.
+ *          This function doesn't call the scheduler.
+ */
+void k_MsgWait(pmsg_t* msg, size_t* retsize)
+{
+    pmsgbox_t* dst_box = &msgbox[msg->dst];
+
+    (*retsize) = 0;
+
+    dst_box->wait_msg = msg;
+    dst_box->retsize = retsize;
+    BlockPCB(dst_box->owner, BLOCKED);
+
+    // A sender blocked on the box might have the awaited message
+    if (dst_box->send_q != NULL)    k_MsgSendAdmit(dst_box);
+}
+
+/**
+ * @brief   Takes a message out of the first box in a set that has one queued.
+ * @param   [in,out] msg: Pointer to the receiver's message slot.
+ *                        Its dst is set to the box the message was taken from.
+ * @param   [in] set: Bitmap of the boxes to receive from.
+ * @param   [out] retsize: Number of bytes successfully received.
+ * @return  True if a message was received,
+ *          False if none of the boxes has a message queued.
+ * @details Boxes are checked in ID order.
+ */
+bool k_MsgFetchAny(pmsg_t* msg, bitmap_t* set, size_t* retsize)
+{
+    uint32_t box = FindSet(set, 0, BOXID_MAX);
+
+    (*retsize) = 0;
+
+    while (box < BOXID_MAX) {
+        msg->dst = box;
+        msg->src = ANY_BOX;
+
+        if (k_MsgFetch(msg, retsize))   return true;
+
+        box = FindSet(set, box+1, BOXID_MAX);
+    }
+
+    return false;
+}
+
+/**
+ * @brief   Blocks a process until a message arrives on any box of a set.
+ * @param   [in,out] msg: Pointer to the receiver's message slot.
+ * @param   [in] set: Bitmap of the boxes to wait on. All have to be owned by proc.
+ * @param   [out] retsize: Number of bytes successfully received.
+ * @param   [in,out] proc: Process to block.
+ * @details The message slot is registered on every box of the set.
+ *          The first message to arrive on any of them is delivered into it,
+ *          and the wait is then cancelled on all other boxes.
+ *          This function doesn't call the scheduler.
+ */
+void k_MsgWaitAny(pmsg_t* msg, bitmap_t* set, size_t* retsize, pcb_t* proc)
+{
+    uint32_t box = FindSet(set, 0, BOXID_MAX);
+
+    (*retsize) = 0;
+
+    while (box < BOXID_MAX) {
+        msgbox[box].wait_msg = msg;
+        msgbox[box].retsize = retsize;
+        SetBit(proc->wait_set, box);
+
+        box = FindSet(set, box+1, BOXID_MAX);
+    }
+
+    BlockPCB(proc, BLOCKED);
+
+    box = FindSet(set, 0, BOXID_MAX);
+
+    // The first blocked sender to get in ends the wait
+    while (box < BOXID_MAX && proc->state == BLOCKED) {
+        if (msgbox[box].send_q != NULL) k_MsgSendAdmit(&msgbox[box]);
+
+        box = FindSet(set, box+1, BOXID_MAX);
+    }
+}
+
+/**
+ * @brief   Cancels the wait of a process on all boxes of its wait set.
+ * @param   [in,out] proc: Process that was waiting on several boxes.
+ */
+void k_MsgWaitCancel(pcb_t* proc)
+{
+    uint32_t box = FindSet(proc->wait_set, 0, BOXID_MAX);
+
+    while (box < BOXID_MAX) {
+        msgbox[box].wait_msg = NULL;
+        msgbox[box].retsize = NULL;
+        ClearBit(proc->wait_set, box);
+
+        box = FindSet(proc->wait_set, box+1, BOXID_MAX);
+    }
+}
+
+/**
+ * @brief   Recieves a message from a process to another.
+ * @param   [in,out] dst_msg:
+ *              Pointer to the receiver's message slot.
+ *              A message that is awaiting to be received will be copied here.
+ * @param   [out] retsize: Number of bytes successfully received.
+ * @details If there isn't any messages to receive,
+ *          the dst_msg and retsize's addresses are copied onto the receiver's
+ *          message box and the process that owns the message box is then blocked
+ *          while it awaits for another process to send it a message.
+ */
+void k_MsgRecv(pmsg_t* msg, size_t* retsize)
+{
+    if (!k_MsgFetch(msg, retsize)) {
+        k_MsgWait(msg, retsize);
+        PendSV();
+    }
+}
+
+/**
+ * @brief   Transfers a message to another.
+ * @param   [in,out] dst: Pointer to message that will be overwritten
+ * @param   [in] src: Pointer to src message whose contents will be copied.
+ * @return  Amount of bytes successfully transfered from one message to another.
+ * @details If the destination doesn't have a valid data pointer,
+ *          data won't be transfered, but the size of the "would-be" transfer is
+ *          still recorded.
+ *          This allows for messages that just want the size of the message
+ *          to be possible.
+ */
+inline uint32_t k_pMsgTransfer(pmsg_t* dst, pmsg_t* src)
+{
+    // Truncate if not enough space in dst
+    if (dst->size > src->size)   dst->size = src->size;
+    if (dst->data != NULL && src->data != NULL) {
+        memcpy(dst->data, src->data, dst->size);
+    }
+    dst->src = src->src;
+    dst->corr = src->corr;
+    dst->prio = src->prio;
+
+    return dst->size;
+}
+
+/**
+ * @brief   Copies a message into an allocated pool message.
+ * @param   [in] msg: Message to copy.
+ * @return  Pool message holding the copy,
+ *          NULL if no message could be allocated.
+ */
+inline pmsg_t* k_pMsgCopy(pmsg_t* msg)
+{
+    pmsg_t* msg_out = k_pMsgAllocate(msg->size);
+
+    if (msg_out != NULL) {
+        k_pMsgTransfer(msg_out, msg);
+        msg_out->dst = msg->dst;
+    }
+
+    return msg_out;
+}
+
+/**
+ * @brief   Lends a pool message to a receiver, instead of copying it.
+ * @param   [out] dst: Receiver's message slot. Gets pointed to the pool buffer.
+ * @param   [in,out] src: Pool message to lend.
+ * @param   [in] receiver: Process that will hold the message until it releases it.
+ * @return  Size of the lent message.
+ */
+inline uint32_t k_pMsgLend(pmsg_t* dst, pmsg_t* src, pcb_t* receiver)
+{
+    src->flags = MSG_OWN_BORROWED;
+    src->holder = receiver->id;
+
+    dst->data = src->data;
+    dst->size = src->size;
+    dst->src = src->src;
+    dst->corr = src->corr;
+    dst->prio = src->prio;
+
+    return dst->size;
+}
+
+/**
+ * @brief   Loans a pool message to a process, for it to write a message in place.
+ * @param   [in] size: Size of the message that'll be written.
+ * @param   [in] proc: Process the message is loaned to.
+ * @return  Loaned message,
+ *          NULL if the size is too large or no message could be allocated.
+ */
+pmsg_t* k_MsgLoan(size_t size, pcb_t* proc)
+{
+    pmsg_t* msg = (size <= MSG_MAX_SIZE) ? k_pMsgAllocate(size) : NULL;
+
+    if (msg != NULL) {
+        msg->size = size;
+        msg->flags = MSG_OWN_LOANED;
+        msg->holder = proc->id;
+    }
+
+    return msg;
+}
+
+/**
+ * @brief   Finds the pool message a loaned or borrowed buffer belongs to.
+ * @param   [in] data: Pointer to the start of the buffer.
+ * @param   [in] proc: Process that claims to hold the buffer.
+ * @return  Pool message of the buffer,
+ *          NULL if the buffer isn't a pool buffer held by the process.
+ * @details The class regions are laid out from the smallest class up,
+ *          so the buffer's class is the amount of region starts it's past.
+ *          Class sizes are powers of 2, so the message index is a shift.
+ */
+pmsg_t* k_MsgLoanLookup(uint8_t* data, pcb_t* proc)
+{
+    uint32_t c, offset, i;
+    pmsg_t* msg;
+
+    if (data < msg_pool || data >= msg_pool + MSG_POOL_SIZE)    return NULL;
+
+    c = (data >= msg_class_pool[1]) + (data >= msg_class_pool[2]) + (data >= msg_class_pool[3]);
+
+    offset = (uint32_t)(data - msg_class_pool[c]);
+    if ((offset & (msg_class_size[c] - 1)) != 0)    return NULL;
+
+    i = msg_class_start[c] + (offset >> msg_class_shift[c]);
+    msg = &msg_table[i];
+
+    if (!GetBit(available_msg, i) || msg->holder != proc->id ||
+            (msg->flags != MSG_OWN_LOANED && msg->flags != MSG_OWN_BORROWED)) {
+        return NULL;
+    }
+
+    return msg;
+}
+
+/**
+ * @brief   Returns a loaned or borrowed message to the pool.
+ * @param   [in,out] msg: Pool message to release.
+ */
+void k_MsgRelease(pmsg_t* msg)
+{
+    msg->flags = MSG_OWN_KERNEL;
+    k_pMsgDeallocate(&msg);
+}
+
+/**
+ * @brief   Returns all the messages a process holds to the pool.
+ * @param   [in] proc: Process whose loaned and borrowed messages are released.
+ */
+void k_MsgReleaseAll(pcb_t* proc)
+{
+    int i;
+
+    for (i = 0; i < MSG_MAX; i++) {
+        if (GetBit(available_msg, i) && msg_table[i].holder == proc->id &&
+                (msg_table[i].flags == MSG_OWN_LOANED ||
+                 msg_table[i].flags == MSG_OWN_BORROWED)) {
+            k_MsgRelease(&msg_table[i]);
+        }
+    }
+}
+
+/**
+ * @brief   Clears all Messages currently in the message box.
+ * @param   [in,out] box: Message box to clear messages from.
+ */
+void k_MsgClearAll(pmsgbox_t* box)
+{
+    pmsg_t* msg;
+
+    while ((msg = k_MsgHead(box)) != NULL) {
+        k_MsgDequeue(box, msg);
+        k_pMsgDeallocate(&msg);
+    }
+}
+
+/**
+ * @brief   Gets the message an any-source receive takes out of a message box.
+ * @param   [in] box: Message box to look into.
+ * @return  Oldest message of the highest queued priority,
+ *          NULL if the box is empty.
+ */
+inline pmsg_t* k_MsgHead(pmsgbox_t* box)
+{
+    return (box->recv_prio == 0) ? NULL : box->recv_msgq[HighestSet(box->recv_prio)];
+}
+
+/**
+ * @brief   Queues a message into a message box.
+ * @param   [in,out] box: Message box receiving the message.
+ * @param   [in,out] msg: Pool message to queue.
+ * @details The message is linked at the back of the box' receive queue
+ *          of its priority, and into the queue of messages from its source
+ *          behind all messages of the same or a higher priority.
+ *          Both any-source and selective receives take the most urgent message
+ *          without searching. Only messages that overtake others from
+ *          their source walk that source's queue.
+ */
+inline void k_MsgEnqueue(pmsgbox_t* box, pmsg_t* msg)
+{
+    pmsg_t** prio_q = &box->recv_msgq[msg->prio];
+    pmsg_t** src_q = &box->src_msgq[msg->src];
+    pmsg_t* front = *src_q;
+
+    box->depth++;
+
+    if (*prio_q == NULL) {
+        *prio_q = msg;
+        SetBit(&box->recv_prio, msg->prio);
+    }
+    dLink(&msg->list, &(*prio_q)->list);
+
+    if (front != NULL && SRC_LIST_MSG(front->src_list.prev)->prio < msg->prio) {
+        // Overtakes the less urgent messages at the back of the source's queue
+        front = SRC_LIST_MSG(front->src_list.prev);
+
+        while (front != *src_q && SRC_LIST_MSG(front->src_list.prev)->prio < msg->prio) {
+            front = SRC_LIST_MSG(front->src_list.prev);
+        }
+
+        dLink(&msg->src_list, &front->src_list);
+
+        if (front == *src_q)    *src_q = msg;
+    }
+    else {
+        if (*src_q == NULL) *src_q = msg;
+        dLink(&msg->src_list, &(*src_q)->src_list);
+    }
+}
+
+/**
+ * @brief   Takes a queued message out of a message box.
+ * @param   [in,out] box: Message box the message is queued in.
+ * @param   [in,out] msg: Queued message to remove.
+ */
+inline void k_MsgDequeue(pmsgbox_t* box, pmsg_t* msg)
+{
+    pmsg_t** prio_q = &box->recv_msgq[msg->prio];
+    pmsg_t** src_q = &box->src_msgq[msg->src];
+
+    box->depth--;
+
+    if (*prio_q == msg) {
+        *prio_q = (msg->next == msg) ? NULL : msg->next;
+        if (*prio_q == NULL)    ClearBit(&box->recv_prio, msg->prio);
+    }
+
+    if (*src_q == msg) {
+        *src_q = (msg->src_list.next == &msg->src_list) ?
+                NULL : SRC_LIST_MSG(msg->src_list.next);
+    }
+
+    dUnlink(&msg->list);
+    dUnlink(&msg->src_list);
 }
@@ -5,7 +5,7 @@
  *          inter-process communications via messaging.
  * @author  Manuel Burnay
  * @date    2019.11.18 (Created)
- * @date    2019.11.21 (Last Modified)
+ * @date    2026.10.16 (Last Modified)
  */
 
 #ifndef K_MESSAGING_H
@@ -20,17 +20,76 @@ pmbox_t k_MsgBoxUnbind(pmbox_t id, pcb_t* proc);
 
 void k_MsgBoxUnbindAll(pcb_t* proc);
 
-inline pmsg_t* k_pMsgAllocate();
+pmbox_t k_MsgTopicBind(pmbox_t id, pcb_t* proc);
+bool k_MsgSubscribe(pmbox_t topic, pmbox_t box, pcb_t* proc);
+bool k_MsgUnsubscribe(pmbox_t topic, pmbox_t box, pcb_t* proc);
+bool k_MsgBoxSetDepth(pmbox_t id, uint32_t depth, pcb_t* proc);
+
+inline pmsg_t* k_pMsgAllocate(size_t size);
+inline uint32_t k_pMsgClass(id_t id);
+void k_MsgClassUsage(uint32_t cls, uint32_t* size, uint32_t* count,
+                     uint32_t* used, uint32_t* peak);
 inline void k_pMsgDeallocate(pmsg_t** msg);
+inline pmsg_t* k_pMsgShare(pmsg_t* payload);
+inline void k_pMsgShareFree(pmsg_t* ref);
+inline pmsg_t* k_pMsgUnshare(pmsg_t* ref, pmsg_t* copy);
+
+pcb_t* k_MsgDeliver(pmsg_t* msg, size_t* retsize);
+pcb_t* k_MsgPublish(pmsg_t* msg, size_t* retsize);
+inline bool k_MsgAwaited(pmsgbox_t* box, pmbox_t src);
+bool k_MsgFetch(pmsg_t* msg, size_t* retsize);
+pmsg_t* k_MsgPeek(pmbox_t box, pmbox_t src);
+void k_MsgWait(pmsg_t* msg, size_t* retsize);
+bool k_MsgFetchAny(pmsg_t* msg, bitmap_t* set, size_t* retsize);
+void k_MsgWaitAny(pmsg_t* msg, bitmap_t* set, size_t* retsize, pcb_t* proc);
+void k_MsgWaitCancel(pcb_t* proc);
 
 void k_MsgSend(pmsg_t* msg, size_t* retsize);
+bool k_MsgAdmitted(pmsg_t* msg);
+void k_MsgSendWait(pmsg_t* msg, size_t* retsize, pcb_t* proc);
+void k_MsgSendAdmit(pmsgbox_t* box);
+void k_MsgSendRelease(pmsgbox_t* box);
+
+bool k_MsgSendAsync(pmsg_t* msg, pmbox_t notify, uint32_t tag, pcb_t* proc);
+bool k_MsgAsyncStep(async_op_t* op);
+void k_MsgAsyncRetry();
+inline bool k_MsgAsyncPending();
+void k_MsgAsyncCancelAll(pcb_t* proc);
 void k_MsgRecv(pmsg_t* msg, size_t* retsize);
 
+rpc_ticket_t* k_MsgTicketIssue(pmbox_t client_box, pmbox_t server_box, pcb_t* proc);
+inline rpc_ticket_t* k_MsgTicketLookup(uint32_t id);
+uint32_t k_MsgTicketMatch(pmbox_t client_box, pmbox_t server_box);
+void k_MsgTicketFree(rpc_ticket_t* t);
+void k_MsgTicketCancelAll(pcb_t* proc);
+bool k_MsgTicketHeld(uint32_t id, pcb_t* proc);
+pcb_t* k_MsgReply(rpc_ticket_t* t, pmsg_t* msg, size_t* retsize);
+bool k_MsgFetchReply(pmsg_t* msg, uint32_t id, pcb_t* proc, size_t* retsize);
+void k_MsgWaitReply(pmsg_t* msg, uint32_t id, size_t* retsize, pcb_t* proc);
+
+void k_MsgRequestStart(pcb_t* client, pmbox_t id);
+void k_MsgRequestEnd(pcb_t* client);
+inline void k_MsgBoxLend(pmbox_t id, priority_t priority);
+inline void k_MsgBoxUnlend(pmbox_t id, priority_t priority);
+inline priority_t k_MsgBoxBoost(pmbox_t id);
+
+void k_MsgTimeoutStart(pmbox_t id, uint32_t ticks);
+void k_MsgTimeout(ktimer_t* tmr);
+
 inline uint32_t k_pMsgTransfer(pmsg_t* dst, pmsg_t* src);
+inline pmsg_t* k_pMsgCopy(pmsg_t* msg);
+inline uint32_t k_pMsgLend(pmsg_t* dst, pmsg_t* src, pcb_t* receiver);
+
+pmsg_t* k_MsgLoan(size_t size, pcb_t* proc);
+pmsg_t* k_MsgLoanLookup(uint8_t* data, pcb_t* proc);
+void k_MsgRelease(pmsg_t* msg);
+void k_MsgReleaseAll(pcb_t* proc);
 
 void k_MsgClearAll(pmsgbox_t* box);
 
-pmsg_t* k_SearchMessageList(pmsg_t* msg, pmbox_t box);
+inline pmsg_t* k_MsgHead(pmsgbox_t* box);
+inline void k_MsgEnqueue(pmsgbox_t* box, pmsg_t* msg);
+inline void k_MsgDequeue(pmsgbox_t* box, pmsg_t* msg);
 
 inline pid_t OwnerPID(pmbox_t boxID);
 
@@ -4,7 +4,7 @@
  *          supporting functionality related to the kernel processes.
  * @author  Manuel Burnay
  * @date    2019.11.13  (Created)
- * @date    2019.11.29  (Last Modified)
+ * @date    2026.10.16  (Last Modified)
  */
 
 
@@ -14,11 +14,27 @@
 #include "k_processes.h"
 #include "k_scheduler.h"
 #include "k_cpu.h"
+#include "k_timer.h"
+#include "k_messaging.h"
 #include "bitmap.h"
 
 bitmap_t available_pid[PID_BITMAP_SIZE];
 pcb_t   proc_table[PID_MAX];
 
+extern pmsgbox_t msgbox[BOXID_MAX];
+
+#define RM_BOUND_ENTRIES    16      /// Amount of task counts with a tabled RM bound.
+#define RM_BOUND_LIMIT      45426   /// RM bound as the task count grows (ln 2).
+
+/**
+ * @brief   Rate-monotonic (Liu & Layland) utilization bound, n*(2^(1/n) - 1),
+ *          for 1 to RM_BOUND_ENTRIES tasks.
+ */
+const uint32_t rm_bound[RM_BOUND_ENTRIES] = {
+    65536, 54291, 51102, 49599, 48725, 48154, 47751, 47452,
+    47221, 47037, 46887, 46763, 46658, 46569, 46492, 46424
+};
+
 /**
  * @brief   Initializes the kernel's process data structures and parameters.
  */
@@ -35,12 +51,151 @@ void process_init()
 
         proc_table[i].state = UNASSIGNED;
 
+        proc_table[i].edf_idx = EDF_UNLINKED;
+        proc_table[i].deadline = 0;
+        proc_table[i].period = 0;
+        proc_table[i].utilization = 0;
+        proc_table[i].req_box = BOXID_MAX;
+        ClearBitRange(proc_table[i].wait_set, 0, BOXID_MAX);
+        proc_table[i].wait_ticket = TICKET_NONE;
+
+        k_TimerSetup(&proc_table[i].alarm, &k_TimerWake, &proc_table[i]);
+        k_TimerSetup(&proc_table[i].replenish, &ReplenishBudget, &proc_table[i]);
+
         ClearBitRange(proc_table[i].owned_box, 0, BOXID_MAX);
     }
 
     ClearBitRange(available_pid, 0, PID_MAX);
 }
 
+/**
+ * @brief   Checks if a periodic process on a priority keeps the periodic processes
+ *          in rate-monotonic order.
+ * @param   [in] pcb: Process being placed, which isn't compared to itself. NULL for a new process.
+ * @param   [in] period: Period of the process (in ms).
+ * @param   [in] priority: Base priority of the process.
+ * @return  True if no periodic process with a longer period runs on a higher priority
+ *          and none with a shorter period runs on a lower one,
+ *          False if not.
+ * @details The EDF band sits above every fixed priority, so it counts as one.
+ *          Processes that share a fixed priority are run round-robin,
+ *          so they need the same period. Processes in the EDF band can have any period.
+ */
+bool k_RateMonotonic(pcb_t* pcb, uint32_t period, priority_t priority)
+{
+    pcb_t* other;
+    int i;
+
+    for (i = 0; i < PID_MAX; i++) {
+        other = &proc_table[i];
+
+        if (!GetBit(available_pid, i) || other == pcb || other->utilization == 0) continue;
+
+        if ((other->base_priority < priority && other->period > period) ||
+                (other->base_priority > priority && other->period < period) ||
+                (other->base_priority == priority && priority != EDF_PRIORITY &&
+                 other->period != period)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief   Checks if a new periodic process can be scheduled
+ *          along with the ones admitted so far.
+ * @param   [in] utilization: CPU utilization of the new process (fixed-point).
+ * @param   [in] period: Period of the new process (in ms).
+ * @param   [in] priority: Base priority of the new process.
+ * @return  True if the process set stays schedulable,
+ *          False if not.
+ * @details A set of EDF processes is schedulable up to a full CPU.
+ *          Once fixed-priority periodic processes are involved, the whole set
+ *          is held to the Liu-Layland rate-monotonic bound for its size.
+ *          The bound only holds for rate-monotonic priorities, so the process
+ *          is turned down if it doesn't keep the set in that order
+ *          (see k_RateMonotonic). The EDF band then takes the place of the
+ *          highest priorities, since its processes have the shortest periods.
+ *          Under that order the test is sufficient, not exact,
+ *          so it might turn down sets that would be schedulable.
+ */
+bool k_Admit(uint32_t utilization, uint32_t period, priority_t priority)
+{
+    uint32_t total = utilization;
+    uint32_t tasks = 1;
+    bool fixed = (priority != EDF_PRIORITY);
+    uint32_t bound;
+    int i;
+
+    for (i = 0; i < PID_MAX; i++) {
+        if (GetBit(available_pid, i) && proc_table[i].utilization != 0) {
+            total += proc_table[i].utilization;
+            tasks++;
+            fixed |= (proc_table[i].base_priority != EDF_PRIORITY);
+        }
+    }
+
+    if (!fixed)                         return (total <= UTIL_ONE);
+
+    if (!k_RateMonotonic(NULL, period, priority))   return false;
+
+    if (tasks <= RM_BOUND_ENTRIES)  bound = rm_bound[tasks-1];
+    else                            bound = RM_BOUND_LIMIT;
+
+    return (total <= bound);
+}
+
+/**
+ * @brief   Re-evaluates the priority of a process, accounting for inheritance.
+ * @param   [in,out] pcb: Pointer to the PCB of the process.
+ * @details A process runs on its base priority (or the background priority
+ *          while throttled), unless a process of higher priority is blocked
+ *          on a request to one of its boxes. In that case it inherits the
+ *          client's priority, so it can't be held back by medium priority work.
+ *          If the process is itself blocked on a request, the change is
+ *          carried on to the owner of that box, and so on down the chain.
+ *          EDF processes keep their band, and EDF clients lend HIGH_PRIORITY,
+ *          as the EDF band only holds processes with deadlines.
+ *          Lent priorities are kept per box (see k_MsgBoxLend), so every step
+ *          only looks at the boxes the process owns.
+ */
+void UpdatePriority(pcb_t* pcb)
+{
+    priority_t priority, boost;
+    uint32_t box;
+    int depth;
+
+    // The depth limit stops request cycles from looping forever
+    for (depth = 0; pcb != NULL && depth < PID_MAX; depth++) {
+        if (IsEDF(pcb)) return;
+
+        priority = (pcb->throttled) ? BACKGROUND_PRIORITY : pcb->base_priority;
+
+        box = FindSet(pcb->owned_box, 0, BOXID_MAX);
+
+        while (box < BOXID_MAX) {
+            boost = k_MsgBoxBoost(box);
+            if (boost < priority)   priority = boost;
+
+            box = FindSet(pcb->owned_box, box+1, BOXID_MAX);
+        }
+
+        if (priority == pcb->priority)  return;
+
+        SetPriority(pcb, priority);
+
+        if (pcb->state != BLOCKED || pcb->req_box >= BOXID_MAX) return;
+
+        // The process lends its new priority to the box it is blocked on
+        k_MsgBoxUnlend(pcb->req_box, pcb->lent_priority);
+        pcb->lent_priority = pcb->priority;
+        k_MsgBoxLend(pcb->req_box, pcb->lent_priority);
+
+        pcb = msgbox[pcb->req_box].owner;
+    }
+}
+
 /**
  * @brief   Creates a process and registers it in kernel space.
  * @param   [in] attr: Pointer to process attributes to configure a process with.
@@ -49,6 +204,11 @@ void process_init()
  *              Pointer to start of the program the process will execute.
  * @retval  Returns the process ID that was created.
  *          PROC_ERR if a process wasn't able to be created.
+ * @details Processes with a deadline or period run in the EDF band,
+ *          unless they ask for a fixed user priority.
+ *          Periodic processes that declare a worst-case execution time
+ *          go through admission control, and are turned down if they'd make
+ *          the periodic process set unschedulable.
  */
 pid_t k_pcreate(process_attr_t* attr, void (*program)(), void (*terminate)())
 {
@@ -57,19 +217,61 @@ pid_t k_pcreate(process_attr_t* attr, void (*program)(), void (*terminate)())
     pid_t id = (attr == NULL || attr->id == 0) ?
             FindClear(available_pid, 0, PID_MAX) : attr->id;
 
-    priority_t priority = (attr == NULL || attr->priority < 2) ?
+    priority_t priority = (attr == NULL || attr->priority < HIGH_PRIORITY) ?
             USER_PRIORITY : attr->priority;
 
+    // Processes with timing constraints are scheduled by deadline
+    uint32_t deadline = (attr == NULL) ? 0 :
+            (attr->deadline != 0) ? attr->deadline : attr->period;
+
+    if (deadline != 0 && attr->priority < HIGH_PRIORITY)    priority = EDF_PRIORITY;
+
+    // Density of the process (utilization when the deadline is the period)
+    uint32_t utilization = 0;
+    uint32_t window = (attr == NULL || attr->period == 0 || deadline < attr->period) ?
+            deadline : attr->period;
+
+    if (attr != NULL && attr->wcet != 0 && attr->period != 0) {
+        utilization = (attr->wcet <= window) ?
+                ((attr->wcet << UTIL_SHIFT) / window) : UTIL_ONE + 1;
+    }
+
     bool err = (
             id > PID_MAX ||
             GetBit(available_pid, id) ||
-            priority > PRIORITY_LEVELS
+            priority > LOWEST_PRIORITY ||
+            (utilization != 0 && !k_Admit(utilization, attr->period, priority))
         );
 
     if (!err) {
         pcb = k_AllocatePCB(id);
         pcb->state = WAITING_TO_RUN;
 
+        pcb->quantum = (attr == NULL) ? 0 : attr->quantum;
+        pcb->preemptions = 0;
+
+        pcb->deadline = deadline;
+        pcb->period = (attr == NULL) ? 0 : attr->period;
+        pcb->utilization = utilization;
+        pcb->deadline_misses = 0;
+        pcb->jobs = 0;
+        pcb->jitter_max = 0;
+        pcb->response_last = 0;
+        pcb->response_max = 0;
+
+        // CPU budgets only apply to the fixed-priority levels
+        pcb->base_priority = priority;
+        pcb->budget = (attr == NULL || priority == EDF_PRIORITY ||
+                attr->budget_period == 0) ? 0 : attr->budget;
+        pcb->budget_left = pcb->budget;
+        pcb->budget_period = (pcb->budget == 0) ? 0 : attr->budget_period;
+        pcb->throttled = false;
+        pcb->req_box = BOXID_MAX;
+
+        // The first job is released on creation
+        pcb->release = k_GetTime();
+        if (deadline != 0)  ReleaseJob(pcb);
+
         if (attr != NULL && strlen(attr->name) != 0) {
             strcpy(pcb->name, attr->name);
         }
@@ -5,7 +5,7 @@
  * @details This module should not be exposed to user programs.
  * @author  Manuel Burnay
  * @date    2019.10.23 (Created)
- * @date    2019.10.23 (Last Modified)
+ * @date    2026.10.16 (Last Modified)
  */
 
 #ifndef     K_PROCESSES_H
@@ -15,6 +15,9 @@
 
 void process_init();
 
+bool k_RateMonotonic(pcb_t* pcb, uint32_t period, priority_t priority);
+bool k_Admit(uint32_t utilization, uint32_t period, priority_t priority);
+void UpdatePriority(pcb_t* pcb);
 pid_t k_pcreate(process_attr_t* attr, void (*program)(), void (*terminate)());
 pcb_t* k_AllocatePCB(pid_t id);
 inline void k_DeallocatePCB(pid_t id);
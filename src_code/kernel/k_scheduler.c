@@ -5,14 +5,46 @@
  * @details This module should not be exposed to user programs.
  * @author  Manuel Burnay
  * @date    2019.10.23  (Created)
- * @date    2019.11.29  (Last Modified)
+ * @date    2026.10.16  (Last Modified)
  */
 
 #include <stdio.h>
 #include "k_scheduler.h"
+#include "k_timer.h"
+#include "k_processes.h"
 #include "dlist.h"
+#include "bitmap.h"
 
-pcb_t* ProcessQueue[PROCESS_QUEUES];
+/** @brief  Amount of 32-level groups in the ready-level bitmap. */
+#define READY_GROUPS    BITMAP_SIZE(PROCESS_QUEUES)
+
+#if (READY_GROUPS > BITMAP_WIDTH)
+    #error "Ready-group bitmap cannot cover all the process queues."
+#endif
+
+pcb_t*      ProcessQueue[PROCESS_QUEUES];
+bitmap_t    ReadyGroups;                /// Bitmap of the level groups that aren't empty.
+bitmap_t    ReadyLevels[READY_GROUPS];  /// Bitmap of the process queues that aren't empty.
+uint32_t    LevelQuantum[PROCESS_QUEUES];   /// Default time quantum of each priority level.
+
+pcb_t*      EdfHeap[PID_MAX];   /// Ready EDF processes, as a min-heap on absolute deadline.
+uint32_t    EdfCount;           /// Amount of processes in the EDF heap.
+
+/** @brief  Compares two absolute deadlines, accounting for kernel time wrap-around. */
+#define DeadlineBefore(a, b)    ((int32_t)((a)->abs_deadline - (b)->abs_deadline) < 0)
+
+/**
+ * @brief   Initializes the scheduler's per-level settings.
+ */
+void scheduler_init()
+{
+    int i;
+    for (i = 0; i < PROCESS_QUEUES; i++) {
+        LevelQuantum[i] = LEVEL_RUNTIME(i);
+    }
+
+    EdfCount = 0;
+}
 
 /**
  * @brief   Links a PCB into a specific priority queue.
@@ -20,6 +52,8 @@ pcb_t* ProcessQueue[PROCESS_QUEUES];
  *              pointer to PCB element to link into the respective process queue.
  * @details This function is also used to place the
  *          idle process in the idle process queue.
+ *          Processes linked to the EDF band go into the EDF heap instead
+ *          of a round-robin queue, so their absolute deadline must be set.
  *          This poses a potential risk that processes
  *          may be initialized with a "priority" lower than what is allowed,
  *          but that will only cause that process to never run.
@@ -30,10 +64,17 @@ void LinkPCB(pcb_t *PCB, priority_t proc_lvl)
      * If the process was previously linked to other PCBs,
      * Severe those links before moving the PCB to a new queue.
      */
-    if (PCB->next != NULL && PCB->prev != NULL) {
+    if ((PCB->next != NULL && PCB->prev != NULL) || PCB->edf_idx != EDF_UNLINKED) {
         UnlinkPCB(PCB);
     }
 
+    PCB->priority = proc_lvl;
+
+    if (proc_lvl == EDF_PRIORITY) {
+        EdfInsert(PCB);
+        return;
+    }
+
     if (ProcessQueue[proc_lvl] == NULL) {
         // If the queue where the PCB is being moved to is empty.
         ProcessQueue[proc_lvl] = PCB;
@@ -44,7 +85,8 @@ void LinkPCB(pcb_t *PCB, priority_t proc_lvl)
         dLink(&PCB->list, &ProcessQueue[proc_lvl]->list);
     }
 
-    PCB->priority = proc_lvl;
+    SetBit(ReadyLevels, proc_lvl);
+    SetBit(&ReadyGroups, proc_lvl >> BITMAP_INDEX_MASK);
 }
 
 /**
@@ -55,45 +97,330 @@ void LinkPCB(pcb_t *PCB, priority_t proc_lvl)
  */
 void UnlinkPCB(pcb_t* pcb)
 {
+    if (IsEDF(pcb)) {
+        EdfRemove(pcb);
+        return;
+    }
+
     if (ProcessQueue[pcb->priority] == pcb) {
         if (pcb == pcb->next)   ProcessQueue[pcb->priority] = NULL;
         else                    ProcessQueue[pcb->priority] = pcb->next;
     }
 
     dUnlink(&pcb->list);
+
+    if (ProcessQueue[pcb->priority] == NULL) {
+        ClearBit(ReadyLevels, pcb->priority);
+
+        if (ReadyLevels[pcb->priority >> BITMAP_INDEX_MASK] == 0) {
+            ClearBit(&ReadyGroups, pcb->priority >> BITMAP_INDEX_MASK);
+        }
+    }
 }
 
 /**
  * @brief   Determines which PCB should run next.
  * @return  Pointer to PCB of the next process that should run.
  * @details This function does not perform any process switching.
- *          It simply iterates through the process queues to find
- *          the next available process to run.
+ *          The highest priority queue with processes in it is found
+ *          from the two-level ready bitmap (group, then level within the group),
+ *          so the cost of this function doesn't depend on the amount of priority levels.
+ *          We are assuming here that there will always be an idle process,
+ *          so the bitmap is never empty.
+ *          In the EDF band, the process with the earliest deadline runs.
  */
 pcb_t* Schedule()
 {
-    pcb_t* front;
-    pcb_t* retval = NULL;
-    int i = 0;
+    uint32_t grp = LowestSet(ReadyGroups);
+    uint32_t lvl = (grp << BITMAP_INDEX_MASK) + LowestSet(ReadyLevels[grp]);
+
+    if (lvl == EDF_PRIORITY)    return EdfHeap[0];
+
+    pcb_t* retval = ProcessQueue[lvl];
+
+    // The front of queue then moves to the next process to run.
+    ProcessQueue[lvl] = retval->next;
+
+    return retval;
+}
+
+/**
+ * @brief   Checks if a process can be switched to without a scheduling pass.
+ * @param   [in] pcb: Pointer to the PCB of a process that is ready to run.
+ * @return  True if the process is on the highest ready level
+ *          (and is the earliest deadline, in the EDF band),
+ *          False if Schedule() could pick another process.
+ * @details Used by the IPC fast path, which switches straight to the other
+ *          side of a request. Processes on the same level aren't rotated,
+ *          so the process jumps ahead of its level's round-robin order.
+ */
+bool CanHandoff(pcb_t* pcb)
+{
+    uint32_t grp = LowestSet(ReadyGroups);
+    uint32_t lvl = (grp << BITMAP_INDEX_MASK) + LowestSet(ReadyLevels[grp]);
 
-    while (i < PRIORITY_LEVELS && retval == NULL) {
-        front = ProcessQueue[i];
-        if (front != NULL) {    // If this priority queue isn't empty.
-            // The process in front of queue is determined to run next.
-            retval = front;
+    if (pcb->priority != lvl)   return false;
 
-            // The front of queue then moves to the next process to run.
-            ProcessQueue[i] = front->next;
+    return (lvl != EDF_PRIORITY || EdfHeap[0] == pcb);
+}
+
+/**
+ * @brief   Places a PCB in the EDF heap at a specific position.
+ */
+inline void EdfPlace(pcb_t* pcb, uint32_t i)
+{
+    EdfHeap[i] = pcb;
+    pcb->edf_idx = i;
+}
+
+/**
+ * @brief   Moves a PCB up the EDF heap until its parent is due before it.
+ * @param   [in] i: Heap position of the PCB.
+ */
+void EdfSiftUp(uint32_t i)
+{
+    pcb_t* pcb = EdfHeap[i];
+    uint32_t parent;
+
+    while (i > 0) {
+        parent = (i - 1) >> 1;
+
+        if (!DeadlineBefore(pcb, EdfHeap[parent]))  break;
+
+        EdfPlace(EdfHeap[parent], i);
+        i = parent;
+    }
+
+    EdfPlace(pcb, i);
+}
+
+/**
+ * @brief   Moves a PCB down the EDF heap until its children are due after it.
+ * @param   [in] i: Heap position of the PCB.
+ */
+void EdfSiftDown(uint32_t i)
+{
+    pcb_t* pcb = EdfHeap[i];
+    uint32_t child;
+
+    while ((child = (i << 1) + 1) < EdfCount) {
+        if (child + 1 < EdfCount && DeadlineBefore(EdfHeap[child+1], EdfHeap[child])) {
+            child++;
         }
-        i++;
+
+        if (!DeadlineBefore(EdfHeap[child], pcb))   break;
+
+        EdfPlace(EdfHeap[child], i);
+        i = child;
     }
 
-    if (retval == NULL) {
-        // We are assuming here that there will always be an idle process.
-        // Which if not then this is a weird self-prank
-        retval = ProcessQueue[IDLE_LEVEL];
+    EdfPlace(pcb, i);
+}
+
+/**
+ * @brief   Inserts a ready process into the EDF heap.
+ * @param   [in,out] pcb: Pointer to the PCB. Its absolute deadline must be set.
+ */
+void EdfInsert(pcb_t* pcb)
+{
+    EdfHeap[EdfCount] = pcb;
+    EdfCount++;
+    EdfSiftUp(EdfCount - 1);
+
+    SetBit(ReadyLevels, EDF_PRIORITY);
+    SetBit(&ReadyGroups, EDF_PRIORITY >> BITMAP_INDEX_MASK);
+}
+
+/**
+ * @brief   Removes a process from the EDF heap.
+ * @param   [in,out] pcb: Pointer to the PCB. Nothing happens if it isn't in the heap.
+ */
+void EdfRemove(pcb_t* pcb)
+{
+    uint32_t i = pcb->edf_idx;
+    pcb_t* last;
+
+    if (i == EDF_UNLINKED)  return;
+
+    EdfCount--;
+    pcb->edf_idx = EDF_UNLINKED;
+
+    if (i != EdfCount) {
+        // Fill the hole with the last element and restore the heap around it
+        last = EdfHeap[EdfCount];
+        EdfPlace(last, i);
+        EdfSiftDown(i);
+        EdfSiftUp(last->edf_idx);
     }
 
-    return retval;
+    if (EdfCount == 0) {
+        ClearBit(ReadyLevels, EDF_PRIORITY);
+
+        if (ReadyLevels[EDF_PRIORITY >> BITMAP_INDEX_MASK] == 0) {
+            ClearBit(&ReadyGroups, EDF_PRIORITY >> BITMAP_INDEX_MASK);
+        }
+    }
+}
+
+/**
+ * @brief   Releases a new job of a process with a deadline.
+ * @param   [in,out] pcb: Pointer to the PCB. Must not be in the EDF heap.
+ * @details Periodic processes are released at their nominal release time,
+ *          which is kept by the process' period.
+ *          Any other process is released now.
+ *          The job is due its relative deadline after its release.
+ */
+void ReleaseJob(pcb_t* pcb)
+{
+    if (pcb->period == 0)   pcb->release = k_GetTime();
+
+    pcb->abs_deadline = pcb->release + pcb->deadline;
+    pcb->job_started = false;
+}
+
+/**
+ * @brief   Records the dispatch of a process' current job.
+ * @param   [in,out] pcb: Pointer to the PCB of the dispatched process.
+ * @details Only the first dispatch of a job counts towards its release jitter.
+ */
+void JobStart(pcb_t* pcb)
+{
+    uint32_t jitter;
+
+    if (pcb->deadline != 0 && !pcb->job_started) {
+        pcb->job_started = true;
+
+        jitter = k_GetTime() - pcb->release;
+        if (jitter > pcb->jitter_max)   pcb->jitter_max = jitter;
+    }
+}
+
+/**
+ * @brief   Records the completion of a process' current job.
+ * @param   [in,out] pcb: Pointer to the PCB of the process.
+ * @details A job completed past its absolute deadline is counted as a miss.
+ */
+void JobComplete(pcb_t* pcb)
+{
+    uint32_t now = k_GetTime();
+
+    pcb->jobs++;
+    pcb->response_last = now - pcb->release;
+    if (pcb->response_last > pcb->response_max) pcb->response_max = pcb->response_last;
+
+    if ((int32_t)(now - pcb->abs_deadline) > 0) pcb->deadline_misses++;
+}
+
+/**
+ * @brief   Charges CPU time to a process' budget.
+ * @param   [in,out] pcb: Pointer to the PCB of the process that ran.
+ * @param   [in] ticks: Amount of ticks the process ran for.
+ * @return  True if the process exhausted its budget (and was throttled),
+ *          False if not.
+ * @details Budgets are replenished sporadic-server style: the first charge
+ *          after a replenishment marks the activation, and the budget is
+ *          replenished a budget period after it. This bounds the CPU time
+ *          the process takes from lower levels to its budget per period.
+ *          A throttled process runs on BACKGROUND_PRIORITY until then.
+ */
+bool ChargeBudget(pcb_t* pcb, uint32_t ticks)
+{
+    if (pcb->budget == 0 || pcb->throttled || ticks == 0)   return false;
+
+    if (pcb->budget_left == pcb->budget) {
+        k_TimerStart(&pcb->replenish, pcb->budget_period);
+    }
+
+    if (ticks < pcb->budget_left) {
+        pcb->budget_left -= ticks;
+        return false;
+    }
+
+    pcb->budget_left = 0;
+    pcb->throttled = true;
+    UpdatePriority(pcb);
+
+    return true;
 }
 
+/**
+ * @brief   Timer expire function that replenishes a process' budget.
+ * @param   [in] tmr: Replenish timer of the process, with its PCB as argument.
+ * @details A throttled process is moved back to its base priority.
+ */
+void ReplenishBudget(ktimer_t* tmr)
+{
+    pcb_t* pcb = (pcb_t*)tmr->arg;
+
+    pcb->budget_left = pcb->budget;
+
+    if (pcb->throttled) {
+        pcb->throttled = false;
+        UpdatePriority(pcb);
+    }
+}
+
+/**
+ * @brief   Changes the priority a process runs on.
+ * @param   [in,out] pcb: Pointer to the PCB of the process.
+ * @param   [in] priority: New priority.
+ * @details Processes that are ready to run are moved to the new level's queue,
+ *          blocked ones are placed there once they wake up.
+ */
+void SetPriority(pcb_t* pcb, priority_t priority)
+{
+    if (pcb->state == RUNNING || pcb->state == WAITING_TO_RUN) {
+        LinkPCB(pcb, priority);
+    }
+    else {
+        pcb->priority = priority;
+    }
+}
+
+/**
+ * @brief   Takes a process out of its process queue.
+ * @param   [in,out] pcb: Pointer to the PCB of the process to block.
+ * @param   [in] state: State the process waits in (e.g. BLOCKED, SLEEPING).
+ */
+void BlockPCB(pcb_t* pcb, proc_state state)
+{
+    UnlinkPCB(pcb);
+    pcb->state = state;
+}
+
+/**
+ * @brief   Places a blocked process back into its process queue.
+ * @param   [in,out] pcb: Pointer to the PCB of the process to wake up.
+ * @details A process with a deadline that wakes up from sleeping starts a new job.
+ *          One that wakes up from blocking carries on with its current job.
+ */
+void WakePCB(pcb_t* pcb)
+{
+    if (pcb->deadline != 0 && pcb->state == SLEEPING)   ReleaseJob(pcb);
+
+    LinkPCB(pcb, pcb->priority);
+    pcb->state = WAITING_TO_RUN;
+}
+
+/**
+ * @brief   Gets the time quantum a process runs for.
+ * @param   [in] pcb: Pointer to the process' PCB.
+ * @return  The process' own quantum if it has one,
+ *          otherwise the default quantum of its priority level (in ms).
+ */
+uint32_t GetQuantum(pcb_t* pcb)
+{
+    return (pcb->quantum != 0) ? pcb->quantum : LevelQuantum[pcb->priority];
+}
+
+/**
+ * @brief   Sets the default time quantum of a priority level.
+ * @param   [in] lvl: Priority level to configure.
+ * @param   [in] quantum: New default quantum in ms. Ignored if 0.
+ */
+void SetLevelQuantum(priority_t lvl, uint32_t quantum)
+{
+    if (lvl < PROCESS_QUEUES && quantum != 0) {
+        LevelQuantum[lvl] = quantum;
+    }
+}
@@ -4,7 +4,7 @@
  * @details This module should not be exposed to user programs.
  * @author  Manuel Burnay
  * @date    2019.10.23  (Created)
- * @date    2019.11.21  (Last Modified)
+ * @date    2026.10.16  (Last Modified)
  */
 
 #ifndef     K_SCHEDULER_H
@@ -12,8 +12,34 @@
 
 #include "k_types.h"
 
+/** @brief  EDF heap position of a process that isn't in the heap. */
+#define EDF_UNLINKED    0xFFFFFFFF
+
+/** @brief  Checks if a process belongs to the EDF band. */
+#define IsEDF(pcb)      ((pcb)->priority == EDF_PRIORITY)
+
+void scheduler_init();
+
 void LinkPCB(pcb_t *newPCB, priority_t proc_lvl);
 void UnlinkPCB(pcb_t* pcb);
 pcb_t* Schedule();
+bool CanHandoff(pcb_t* pcb);
+
+void EdfInsert(pcb_t* pcb);
+void EdfRemove(pcb_t* pcb);
+void ReleaseJob(pcb_t* pcb);
+void JobStart(pcb_t* pcb);
+void JobComplete(pcb_t* pcb);
+
+bool ChargeBudget(pcb_t* pcb, uint32_t ticks);
+void ReplenishBudget(ktimer_t* tmr);
+
+void SetPriority(pcb_t* pcb, priority_t priority);
+
+void BlockPCB(pcb_t* pcb, proc_state state);
+void WakePCB(pcb_t* pcb);
+
+uint32_t GetQuantum(pcb_t* pcb);
+void SetLevelQuantum(priority_t lvl, uint32_t quantum);
 
 #endif	//  K_SCHEDULER_H
@@ -5,7 +5,7 @@
  *          supporting functionality.
  * @author  Manuel Burnay
  * @date    2019.11.22 (Created)
- * @date    2019.11.29 (Last Modified)
+ * @date    2026.10.16 (Last Modified)
  */
 
 #include <stdio.h>
@@ -17,9 +17,11 @@
 #include "uart.h"
 #include "k_processes.h"
 #include "k_scheduler.h"
+#include "k_timer.h"
+#include "k_messaging.h"
 #include "cstr_utils.h"
 
-enum SUPPORTED_COMMANDS {PS, IO_ON, IO_OFF, RUN, COMMANDS_SIZE};
+enum SUPPORTED_COMMANDS {PS, IO_ON, IO_OFF, RUN, MSG, COMMANDS_SIZE};
 
 /**
  * @brief   Supported command keywords. Commands are case insensitive.
@@ -30,14 +32,15 @@ enum SUPPORTED_COMMANDS {PS, IO_ON, IO_OFF, RUN, COMMANDS_SIZE};
  *               and lets user processes run.
  */
 const char* const COMMAND[] = {
-    "PS", "IO_ON", "IO_OFF", "RUN"
+    "PS", "IO_ON", "IO_OFF", "RUN", "MSG"
 };
 
 bool (* const CommHandler[])(char*, terminal_t*) = {
     ProcessStatus,
     EnableIO,
     DisableIO,
-    run
+    run,
+    MessageStatus
 };
 
 /**
@@ -186,7 +189,8 @@ void terminal()
     ResetScreen();
     SendHeader(term.header);
 
-    uint8_t rx_buf[MSG_MAX_SIZE];
+    // Requests are either a UART character or IO metadata
+    uint8_t rx_buf[sizeof(IO_metadata_t)];
 
     ChangeProcessPriority(IDLE_ID, 1);
 
@@ -198,8 +202,16 @@ void terminal()
     uint8_t* uart_char = (uint8_t*)rx_buf;
     pmbox_t src_box;
 
+    // Reply owed to the last request, sent along with the next receive
+    pmbox_t reply_box = BOXID_MAX;
+    uint8_t* reply_data = NULL;
+    size_t reply_size = 0;
+
     while (1) {
-        recv(term.box, ANY_BOX, rx_buf, MSG_MAX_SIZE, &src_box);
+        reply_wait(term.box, reply_box, reply_data, reply_size,
+                   rx_buf, sizeof(rx_buf), &src_box);
+
+        reply_box = BOXID_MAX;
 
         if (src_box == IO_BOX) {
             // Process UART input
@@ -215,14 +227,18 @@ void terminal()
             if (IO_meta->is_send) {
                 UART0_puts((char*)IO_meta->send_data);
                 // Sends data back just so the sender's recv gets the size sent to uart.
-                send(src_box, term.box, IO_meta->send_data, IO_meta->size);
+                reply_box = src_box;
+                reply_data = IO_meta->send_data;
+                reply_size = IO_meta->size;
             }
             else {
                 ConfigureInputCapture(&term.capture, IO_meta, src_box);
             }
         }
         else {
-            send(src_box, term.box, "", 0);
+            reply_box = src_box;
+            reply_data = (uint8_t*)"";
+            reply_size = 0;
         }
     }
 }
@@ -342,6 +358,41 @@ bool CommandCheck(terminal_t* term)
     return valid_command;
 }
 
+/**
+ * @brief   Displays the occupancy of every message pool size class.
+ * @param   [in] attr:
+ *              pointer to attribute string associated
+ *              with command (not used in this command).
+ * @param   [in] term: pointer to active terminal (not used in this command).
+ * @returns true.
+ */
+bool MessageStatus(char* attr, terminal_t* term)
+{
+    uint32_t size, count, used, peak;
+
+    char num_buf[INT_BUF];
+
+    int c;
+    for (c = 0; c < MSG_CLASSES; c++) {
+        k_MsgClassUsage(c, &size, &count, &used, &peak);
+
+        UART0_puts("-- Class ");
+        UART0_puts(itoa(c, num_buf));
+        UART0_puts(" (");
+        UART0_puts(itoa((int)size, num_buf));
+        UART0_puts(" B): ");
+        UART0_puts(itoa((int)used, num_buf));
+        UART0_puts("/");
+        UART0_puts(itoa((int)count, num_buf));
+        UART0_puts(" in use, peak ");
+        UART0_puts(itoa((int)peak, num_buf));
+        UART0_puts("\n");
+    }
+
+    UART0_puts("> ");
+    return true;
+}
+
 /**
  * @brief   Displays information about the system and allocated processes.
  * @param   [in] attr:
@@ -356,6 +407,12 @@ bool ProcessStatus(char* attr, terminal_t* term)
 
     char num_buf[INT_BUF];
 
+    UART0_puts("Uptime (ms): ");
+    UART0_puts(itoa((int)k_GetTime(), num_buf));
+    UART0_puts("\nSysTick interrupts: ");
+    UART0_puts(itoa((int)k_GetTickCount(), num_buf));
+    UART0_puts("\n");
+
     int i;
     for(i = 0; i < PID_MAX; i++) {
         pcb = GetPCB((pid_t)i);
@@ -376,6 +433,8 @@ bool ProcessStatus(char* attr, terminal_t* term)
                     break;
                 case BLOCKED: UART0_puts("Blocked");
                     break;
+                case SLEEPING: UART0_puts("Sleeping");
+                    break;
                 case TERMINATED: UART0_puts("Terminated");
                     break;
             }
@@ -384,6 +443,48 @@ bool ProcessStatus(char* attr, terminal_t* term)
             UART0_puts("Priority:   ");
             UART0_puts(itoa((int)pcb->priority, num_buf));
 
+            UART0_puts("\n---- ");
+            UART0_puts("Quantum:    ");
+            UART0_puts(itoa((int)GetQuantum(pcb), num_buf));
+
+            UART0_puts("\n---- ");
+            UART0_puts("Preempted:  ");
+            UART0_puts(itoa((int)pcb->preemptions, num_buf));
+
+            if (pcb->budget != 0) {
+                UART0_puts("\n---- ");
+                UART0_puts("Budget:     ");
+                UART0_puts(itoa((int)pcb->budget_left, num_buf));
+                UART0_puts("/");
+                UART0_puts(itoa((int)pcb->budget, num_buf));
+                if (pcb->throttled) UART0_puts(" (throttled)");
+            }
+
+            if (pcb->deadline != 0) {
+                UART0_puts("\n---- ");
+                UART0_puts("Deadline:   ");
+                UART0_puts(itoa((int)pcb->deadline, num_buf));
+
+                UART0_puts("\n---- ");
+                UART0_puts("Misses:     ");
+                UART0_puts(itoa((int)pcb->deadline_misses, num_buf));
+
+                UART0_puts("\n---- ");
+                UART0_puts("Jobs:       ");
+                UART0_puts(itoa((int)pcb->jobs, num_buf));
+
+                UART0_puts("\n---- ");
+                UART0_puts("Max jitter: ");
+                UART0_puts(itoa((int)pcb->jitter_max, num_buf));
+
+                UART0_puts("\n---- ");
+                UART0_puts("Response:   ");
+                UART0_puts(itoa((int)pcb->response_last, num_buf));
+                UART0_puts(" (max ");
+                UART0_puts(itoa((int)pcb->response_max, num_buf));
+                UART0_puts(")");
+            }
+
             UART0_puts("\n---- ");
             UART0_puts("allowed IO: ");
 
@@ -80,6 +80,7 @@ bool CommandCheck(terminal_t* term);
 
 bool ProcessStatus(char* attr_str, terminal_t* term);
 bool EnableIO(char* attr_str, terminal_t* term);
+bool MessageStatus(char* attr_str, terminal_t* term);
 bool DisableIO(char* attr, terminal_t* term);
 bool run(char* attr, terminal_t* term);
 
@@ -0,0 +1,570 @@
+/**
+ * @file    k_timer.c
+ * @brief   Contains the kernel's time keeping, timer service and
+ *          the SysTick programming used to drive them.
+ * @details Timers are kept in a hierarchical timing wheel.
+ *          Level 0 has a slot per tick, and every level above it has slots
+ *          that span a whole rotation of the level below.
+ *          A timer is placed in the lowest level that can hold its expiry time,
+ *          and is moved (cascaded) to lower levels as the wheel turns.
+ *          Every level keeps a bitmap of its non-empty slots, so starting,
+ *          cancelling and expiring a timer, as well as finding the next event,
+ *          is done in constant time regardless of how many timers are armed.
+ * @details This module should not be exposed to user programs.
+ * @author  Manuel Burnay
+ * @date    2026.10.16 (Created)
+ * @date    2026.10.16 (Last Modified)
+ */
+
+#include <stdint.h>
+#include "k_timer.h"
+#include "k_scheduler.h"
+#include "k_messaging.h"
+#include "systick.h"
+#include "k_cpu.h"
+#include "dlist.h"
+#include "bitmap.h"
+
+/** @brief  Amount of SysTick clock cycles in a kernel tick. */
+#define TICK_CYCLES     (F_CPU_CLK/TICK_RATE)
+
+/** @brief  Longest amount of ticks the SysTick can be programmed for. */
+#define TICK_MAX_WAIT   (MAX_WAIT/TICK_CYCLES)
+
+#define WHEEL_BITS      BITMAP_INDEX_MASK   /// log2 of the slots in a wheel level.
+#define WHEEL_SLOTS     BITMAP_WIDTH        /// Slots in a wheel level. One bitmap entry covers a level.
+#define WHEEL_MASK      (WHEEL_SLOTS-1)     /// Mask to find a slot index in a wheel level.
+
+/** @brief  Longest amount of ticks the wheel can hold a timer for without re-cascading it. */
+#define WHEEL_SPAN      ((uint32_t)1 << (WHEEL_BITS*TIMER_WHEEL_LEVELS))
+
+/** @brief  Slot index of a point in time in a wheel level. */
+#define WheelSlot(time, lvl)    (((time) >> (WHEEL_BITS*(lvl))) & WHEEL_MASK)
+
+#if (WHEEL_BITS*TIMER_WHEEL_LEVELS > 31)
+    #error "Timer wheel spans more than half of the kernel time range."
+#endif
+
+uint32_t SystemTime;    /// Kernel time since start-up (in ticks).
+uint32_t SysTickCount;  /// Amount of SysTick interrupts serviced.
+uint32_t TimerCount;    /// Amount of armed timers.
+
+ktimer_t*   Wheel[TIMER_WHEEL_LEVELS][WHEEL_SLOTS]; /// Timer wheel slots.
+bitmap_t    WheelMap[TIMER_WHEEL_LEVELS];           /// Non-empty slots of every wheel level.
+
+bitmap_t        available_timer[BITMAP_SIZE(TIMER_MAX)];
+bitmap_t        fired_timer[BITMAP_SIZE(TIMER_MAX)];    /// User timers that expired and haven't notified their box yet.
+user_timer_t    user_timer[TIMER_MAX];
+
+#if TICKLESS_MODE
+uint32_t tick_cycles;   /// Clock cycles the SysTick was last programmed for.
+uint32_t cycle_residue; /// Clock cycles that haven't been accounted into SystemTime yet.
+#endif
+
+/**
+ * @brief   Initializes the kernel's time keeping and the SysTick driver.
+ */
+void k_TimerInit()
+{
+    int i, j;
+
+    SystemTime = 0;
+    SysTickCount = 0;
+    TimerCount = 0;
+
+    for (i = 0; i < TIMER_WHEEL_LEVELS; i++) {
+        for (j = 0; j < WHEEL_SLOTS; j++) {
+            Wheel[i][j] = NULL;
+        }
+        WheelMap[i] = 0;
+    }
+
+    ClearBitRange(available_timer, 0, TIMER_MAX);
+    ClearBitRange(fired_timer, 0, TIMER_MAX);
+
+    for (i = 0; i < TIMER_MAX; i++) {
+        user_timer[i].id = i;
+        user_timer[i].owner = NULL;
+        k_TimerSetup(&user_timer[i].tmr, &k_UserTimerExpire, &user_timer[i]);
+    }
+
+#if TICKLESS_MODE
+    tick_cycles = TICK_CYCLES;
+    cycle_residue = 0;
+#endif
+
+    SysTick_Init(TICK_RATE);
+}
+
+/**
+ * @brief   Places a timer in the wheel slot that matches its expiry time.
+ * @param   [in,out] tmr: Timer to place. Its expiry time must be in the future.
+ * @details Timers that expire past what the wheel spans are placed in the
+ *          top level's furthest slot and re-placed once it cascades.
+ */
+void k_WheelInsert(ktimer_t* tmr)
+{
+    uint32_t time = tmr->expires;
+    uint32_t delta = time - SystemTime;
+    uint32_t lvl = 0;
+
+    if (delta >= WHEEL_SPAN) {
+        time = SystemTime + WHEEL_SPAN - 1;
+        delta = WHEEL_SPAN - 1;
+    }
+
+    if (delta >= WHEEL_SLOTS) {
+        lvl = ((BITMAP_WIDTH-1) - CLZ(delta)) / WHEEL_BITS;
+    }
+
+    tmr->lvl = lvl;
+    tmr->slot = WheelSlot(time, lvl);
+
+    ktimer_t** head = &Wheel[lvl][tmr->slot];
+
+    if (*head == NULL) {
+        *head = tmr;
+        tmr->next = tmr;
+        tmr->prev = tmr;
+        SetBit(&WheelMap[lvl], tmr->slot);
+    }
+    else {
+        dLink(&tmr->list, &(*head)->list);
+    }
+}
+
+/**
+ * @brief   Takes the first timer out of a wheel slot.
+ * @param   [in] lvl: Wheel level of the slot.
+ * @param   [in] slot: Slot index.
+ * @return  Timer taken out of the slot,
+ *          NULL if the slot was empty.
+ */
+ktimer_t* k_WheelPop(uint32_t lvl, uint32_t slot)
+{
+    ktimer_t* tmr = Wheel[lvl][slot];
+
+    if (tmr != NULL) {
+        k_TimerCancel(tmr);
+    }
+
+    return tmr;
+}
+
+/**
+ * @brief   Moves all the timers in a wheel slot down to the lower levels.
+ * @param   [in] lvl: Wheel level of the slot.
+ * @param   [in] slot: Slot index.
+ * @details The slot is detached before its timers are re-placed,
+ *          so timers that land back in the same slot aren't visited twice.
+ */
+void k_WheelCascade(uint32_t lvl, uint32_t slot)
+{
+    ktimer_t* list = Wheel[lvl][slot];
+    ktimer_t* tmr;
+
+    Wheel[lvl][slot] = NULL;
+    ClearBit(&WheelMap[lvl], slot);
+
+    while (list != NULL) {
+        tmr = list;
+        list = (tmr->next == tmr) ? NULL : tmr->next;
+        dUnlink(&tmr->list);
+
+        k_WheelInsert(tmr);
+    }
+}
+
+/**
+ * @brief   Turns the wheel by one tick.
+ * @return  True if a timer expired,
+ *          False if not.
+ * @details Levels whose slot boundary was reached are cascaded
+ *          from the top down, then the level 0 slot of the new time expires.
+ */
+bool k_WheelTick()
+{
+    ktimer_t* tmr;
+    bool expired = false;
+    int lvl = 1;
+
+    SystemTime++;
+
+    while (lvl < TIMER_WHEEL_LEVELS &&
+            (SystemTime & (((uint32_t)1 << (WHEEL_BITS*lvl)) - 1)) == 0) {
+        lvl++;
+    }
+
+    for (lvl--; lvl > 0; lvl--) {
+        k_WheelCascade(lvl, WheelSlot(SystemTime, lvl));
+    }
+
+    while ((tmr = k_WheelPop(0, WheelSlot(SystemTime, 0))) != NULL) {
+        tmr->expire(tmr);
+        expired = true;
+    }
+
+    return expired;
+}
+
+/**
+ * @brief   Gets the amount of ticks until the wheel has work to do.
+ * @return  Ticks until the next timer expiry or cascade,
+ *          TIMER_NONE if there are no timers armed.
+ * @details For every level, the next non-empty slot after the current one
+ *          is found in the level's bitmap.
+ */
+uint32_t k_TimerNext()
+{
+    uint32_t lvl, cur, start, map, event;
+    uint32_t next = TIMER_NONE;
+
+    for (lvl = 0; lvl < TIMER_WHEEL_LEVELS; lvl++) {
+        map = WheelMap[lvl];
+
+        if (map != 0) {
+            cur = SystemTime >> (WHEEL_BITS*lvl);
+            start = (cur + 1) & WHEEL_MASK;
+
+            // Rotate the bitmap so the slot after the current one is bit 0
+            if (start != 0) map = (map >> start) | (map << (WHEEL_SLOTS - start));
+
+            event = (cur + 1 + LowestSet(map)) << (WHEEL_BITS*lvl);
+
+            if (event - SystemTime < next)  next = event - SystemTime;
+        }
+    }
+
+    return next;
+}
+
+/**
+ * @brief   Moves the kernel time forward and expires all timers that are due.
+ * @param   [in] ticks: Amount of ticks that have elapsed.
+ * @return  True if a timer expired (and a process might need to be scheduled),
+ *          False if not.
+ * @details Ticks where the wheel has no work to do are skipped over,
+ *          so advancing time after a long tickless sleep is cheap.
+ */
+bool k_TimeAdvance(uint32_t ticks)
+{
+    uint32_t next;
+    bool expired = false;
+
+    while (ticks > 0) {
+        next = (TimerCount == 0) ? TIMER_NONE : k_TimerNext();
+
+        if (next > ticks) {
+            SystemTime += ticks;
+            ticks = 0;
+        }
+        else {
+            SystemTime += next - 1;
+            ticks -= next;
+            expired |= k_WheelTick();
+        }
+    }
+
+    return expired;
+}
+
+/**
+ * @brief   Gets the kernel time.
+ * @return  Amount of ticks elapsed since the kernel started.
+ */
+uint32_t k_GetTime()
+{
+#if TICKLESS_MODE
+    return SystemTime + k_TickPending();
+#else
+    return SystemTime;
+#endif
+}
+
+/**
+ * @brief   Gets the amount of SysTick interrupts serviced since start-up.
+ */
+uint32_t k_GetTickCount()
+{
+    return SysTickCount;
+}
+
+/**
+ * @brief   Gets the amount of armed timers.
+ */
+uint32_t k_GetTimerCount()
+{
+    return TimerCount;
+}
+
+/**
+ * @brief   Sets up what happens when a timer expires.
+ * @param   [out] tmr: Timer to set up. Must not be armed.
+ * @param   [in] expire: Function called when the timer expires.
+ * @param   [in] arg: Argument kept in the timer for the expire function.
+ */
+void k_TimerSetup(ktimer_t* tmr, void (*expire)(ktimer_t*), void* arg)
+{
+    tmr->next = NULL;
+    tmr->prev = NULL;
+    tmr->expire = expire;
+    tmr->arg = arg;
+}
+
+/**
+ * @brief   Arms a timer.
+ * @param   [in,out] tmr: Timer to arm. It is re-armed if it was armed already.
+ * @param   [in] ticks: Amount of ticks from now until the timer expires.
+ * @details A timer set for 0 ticks expires on the next tick.
+ */
+void k_TimerStart(ktimer_t* tmr, uint32_t ticks)
+{
+    k_TimerCancel(tmr);
+
+    if (ticks == 0) ticks = 1;
+
+#if TICKLESS_MODE
+    // The wheel hasn't been moved forward by the time the SysTick is counting yet
+    ticks += k_TickPending();
+#endif
+
+    tmr->expires = SystemTime + ticks;
+    k_WheelInsert(tmr);
+    TimerCount++;
+}
+
+/**
+ * @brief   Disarms a timer.
+ * @param   [in,out] tmr: Timer to disarm.
+ * @details Nothing happens if the timer isn't armed.
+ */
+void k_TimerCancel(ktimer_t* tmr)
+{
+    ktimer_t** head;
+
+    if (tmr->next == NULL)  return;
+
+    head = &Wheel[tmr->lvl][tmr->slot];
+
+    if (*head == tmr) {
+        if (tmr->next == tmr) {
+            *head = NULL;
+            ClearBit(&WheelMap[tmr->lvl], tmr->slot);
+        }
+        else {
+            *head = tmr->next;
+        }
+    }
+
+    dUnlink(&tmr->list);
+    TimerCount--;
+}
+
+/**
+ * @brief   Timer expire function that wakes up the process
+ *          kept as the timer's argument.
+ * @param   [in] tmr: Timer that expired.
+ */
+void k_TimerWake(ktimer_t* tmr)
+{
+    WakePCB((pcb_t*)tmr->arg);
+}
+
+/**
+ * @brief   Allocates and arms a user timer.
+ * @param   [in] owner: Process that owns the timer.
+ * @param   [in] box: Message box to notify when the timer expires.
+ * @param   [in] ticks: Amount of ticks until the timer expires.
+ * @param   [in] period: Re-arm period in ticks. 0 for a one-shot timer.
+ * @return  ID of the allocated timer,
+ *          TIMER_ERR if no timer could be allocated.
+ */
+id_t k_UserTimerStart(pcb_t* owner, pmbox_t box, uint32_t ticks, uint32_t period)
+{
+    id_t id = FindClear(available_timer, 0, TIMER_MAX);
+
+    if (id >= TIMER_MAX)    return (id_t)TIMER_ERR;
+
+    SetBit(available_timer, id);
+
+    user_timer[id].owner = owner;
+    user_timer[id].box = box;
+    user_timer[id].period = period;
+
+    k_TimerStart(&user_timer[id].tmr, ticks);
+
+    return id;
+}
+
+/**
+ * @brief   Disarms and de-allocates a user timer.
+ * @param   [in] owner: Process that is cancelling the timer.
+ * @param   [in] id: ID of the timer to cancel.
+ * @return  True if the timer was cancelled,
+ *          False if the timer doesn't exist or isn't owned by the process.
+ */
+bool k_UserTimerCancel(pcb_t* owner, id_t id)
+{
+    if (id >= TIMER_MAX || user_timer[id].owner != owner)  return false;
+
+    k_TimerCancel(&user_timer[id].tmr);
+    user_timer[id].owner = NULL;
+    ClearBit(available_timer, id);
+    ClearBit(fired_timer, id);
+
+    return true;
+}
+
+/**
+ * @brief   Cancels all the user timers owned by a process.
+ * @param   [in] owner: Process whose timers get cancelled.
+ */
+void k_UserTimerCancelAll(pcb_t* owner)
+{
+    id_t id = FindSet(available_timer, 0, TIMER_MAX);
+
+    while (id < TIMER_MAX) {
+        k_UserTimerCancel(owner, id);
+        id = FindSet(available_timer, id+1, TIMER_MAX);
+    }
+}
+
+/**
+ * @brief   Cancels all the user timers that notify a message box.
+ * @param   [in] box: Box ID of the box being unbound.
+ */
+void k_UserTimerCancelBox(pmbox_t box)
+{
+    id_t id = FindSet(available_timer, 0, TIMER_MAX);
+
+    while (id < TIMER_MAX) {
+        if (user_timer[id].box == box)  k_UserTimerCancel(user_timer[id].owner, id);
+        id = FindSet(available_timer, id+1, TIMER_MAX);
+    }
+}
+
+/**
+ * @brief   Timer expire function of user timers.
+ * @param   [in] tmr: Timer that expired.
+ * @details Timers expire in the SysTick interrupt, so the timer is only marked
+ *          as fired and its message is sent by k_UserTimerNotify() from PendSV.
+ *          Periodic timers are re-armed relative to their expiry time,
+ *          so they don't drift. Expiries of a timer that happen before its
+ *          message is sent are merged into one message.
+ */
+void k_UserTimerExpire(ktimer_t* tmr)
+{
+    user_timer_t* utmr = (user_timer_t*)tmr->arg;
+
+    SetBit(fired_timer, utmr->id);
+    PendSV();
+
+    if (utmr->period != 0) {
+        tmr->expires += utmr->period;
+        k_WheelInsert(tmr);
+        TimerCount++;
+    }
+}
+
+/**
+ * @brief   Sends the messages of the user timers that fired.
+ * @details A message carrying the timer ID is sent to every fired timer's box.
+ *          One-shot timers are de-allocated once their message is sent.
+ *          This function doesn't call the scheduler.
+ */
+void k_UserTimerNotify()
+{
+    user_timer_t* utmr;
+    id_t id = FindSet(fired_timer, 0, TIMER_MAX);
+
+    while (id < TIMER_MAX) {
+        utmr = &user_timer[id];
+        ClearBit(fired_timer, id);
+
+        pmsg_t msg = {
+             .dst = utmr->box,
+             .src = utmr->box,
+             .data = (uint8_t*)&utmr->id,
+             .size = sizeof(id_t)
+        };
+
+        k_MsgDeliver(&msg, NULL);
+
+        if (utmr->period == 0)  k_UserTimerCancel(utmr->owner, id);
+
+        id = FindSet(fired_timer, id+1, TIMER_MAX);
+    }
+}
+
+#if TICKLESS_MODE
+/**
+ * @brief   Converts the time counted by the SysTick into kernel ticks.
+ * @param   [in] wrapped:
+ *              True if the SysTick reached the end of its programmed period
+ *              since it was last programmed.
+ * @return  Amount of whole ticks elapsed.
+ * @details Cycles that don't make up a whole tick are carried over
+ *          to the next conversion, so no time is lost between events.
+ *          The SysTick has to be re-programmed before the next conversion,
+ *          otherwise the same cycles are counted twice.
+ */
+uint32_t k_TickElapsed(bool wrapped)
+{
+    uint32_t cycles = cycle_residue + SysTick_Elapsed();
+
+    if (wrapped)    cycles += tick_cycles;
+
+    cycle_residue = cycles % TICK_CYCLES;
+
+    return cycles / TICK_CYCLES;
+}
+
+/**
+ * @brief   Gets the whole ticks counted by the SysTick that haven't been accounted yet.
+ * @details Unlike k_TickElapsed, this doesn't consume the counted time.
+ */
+uint32_t k_TickPending()
+{
+    uint32_t cycles = cycle_residue + SysTick_Elapsed();
+
+    if (SysTick_Pending())  cycles += tick_cycles;
+
+    return cycles / TICK_CYCLES;
+}
+
+/**
+ * @brief   Programs the SysTick to trigger once the next kernel event is due.
+ * @param   [in] ticks: Amount of ticks until the running process' quantum expires.
+ * @details The SysTick is programmed for the earliest of the quantum's expiry
+ *          and the wheel's next expiry or cascade.
+ *          Periods longer than what the SysTick supports are clipped,
+ *          the kernel simply re-programs it once it triggers.
+ */
+void k_TickProgram(uint32_t ticks)
+{
+    uint32_t next = k_TimerNext();
+
+    if (next < ticks)   ticks = next;
+
+    if (ticks == 0)             ticks = 1;
+    if (ticks > TICK_MAX_WAIT)  ticks = TICK_MAX_WAIT;
+
+    tick_cycles = ticks * TICK_CYCLES;
+    SysTick_OneShot(tick_cycles);
+}
+
+/**
+ * @brief   Accounts the time elapsed since the SysTick was last programmed.
+ * @return  Amount of ticks accounted.
+ * @details Used when the kernel preempts the programmed event
+ *          (e.g. on a process switch). k_TickProgram must be called afterwards.
+ */
+uint32_t k_TickSync()
+{
+    uint32_t ticks = k_TickElapsed(SysTick_Expired());
+
+    k_TimeAdvance(ticks);
+
+    return ticks;
+}
+#endif
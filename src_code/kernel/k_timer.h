@@ -0,0 +1,53 @@
+/**
+ * @file    k_timer.h
+ * @brief   Defines all functions and entities related to
+ *          the kernel's time keeping.
+ * @details This module should not be exposed to user programs.
+ * @author  Manuel Burnay
+ * @date    2026.10.16 (Created)
+ * @date    2026.10.16 (Last Modified)
+ */
+
+#ifndef K_TIMER_H
+#define K_TIMER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "k_types.h"
+
+/** @brief  Value returned when there are no timers armed. */
+#define TIMER_NONE  0xFFFFFFFF
+
+void k_TimerInit();
+
+bool k_TimeAdvance(uint32_t ticks);
+uint32_t k_GetTime();
+uint32_t k_GetTickCount();
+uint32_t k_GetTimerCount();
+
+void k_WheelInsert(ktimer_t* tmr);
+ktimer_t* k_WheelPop(uint32_t lvl, uint32_t slot);
+void k_WheelCascade(uint32_t lvl, uint32_t slot);
+bool k_WheelTick();
+uint32_t k_TimerNext();
+
+void k_TimerSetup(ktimer_t* tmr, void (*expire)(ktimer_t*), void* arg);
+void k_TimerStart(ktimer_t* tmr, uint32_t ticks);
+void k_TimerCancel(ktimer_t* tmr);
+void k_TimerWake(ktimer_t* tmr);
+
+id_t k_UserTimerStart(pcb_t* owner, pmbox_t box, uint32_t ticks, uint32_t period);
+bool k_UserTimerCancel(pcb_t* owner, id_t id);
+void k_UserTimerCancelAll(pcb_t* owner);
+void k_UserTimerCancelBox(pmbox_t box);
+void k_UserTimerExpire(ktimer_t* tmr);
+void k_UserTimerNotify();
+
+#if TICKLESS_MODE
+uint32_t k_TickElapsed(bool wrapped);
+uint32_t k_TickPending();
+void k_TickProgram(uint32_t ticks);
+uint32_t k_TickSync();
+#endif
+
+#endif  // K_TIMER_H
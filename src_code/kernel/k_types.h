@@ -3,7 +3,7 @@
  * @brief   Defines all data types used through the kernel
  * @author  Manuel Burnay
  * @date    2019.11.19 (Created)
- * @date    2019.11.21 (Last Modified)
+ * @date    2026.10.16 (Last Modified)
  */
 
 #ifndef K_TYPES_H
@@ -13,6 +13,7 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include "dlist.h"
+#include "spsc.h"
 #include "k_defs.h"
 
 typedef uint32_t    id_t;       /// System ID type alias
@@ -29,22 +30,106 @@ typedef struct pmsg_ {
         node_t list;    /**< list node where other messages connect to. */
     };
 
+    node_t      src_list;   /**< list node for the box' queue of messages from the same source. */
+
     pmbox_t     src;    /**< Box ID where message was sent from. */
     pmbox_t     dst;    /**< Box ID where message is meant to go. */
     size_t      size;   /**< Size of the message contents (in Bytes). */
     id_t        id;     /**< Internal ID number used for msg allocation. */
     uint8_t*    data;   /**< Pointer to Location of the message data. */
+    msg_own_t   flags;  /**< Ownership of the message's buffer. */
+    id_t        holder; /**< Process holding a loaned or borrowed message. */
+    uint32_t    refs;   /**< Subscriber queues holding the message, if it was published. */
+    struct pmsg_*   shared; /**< Published message this header queues (NULL for regular messages). */
+    uint32_t    corr;   /**< Ticket of the asynchronous request the message belongs to. */
+    uint8_t     prio;   /**< Message priority. Higher priorities are received first. */
 } pmsg_t;
 
 /** @brief  Inter-process communication Message box structure */
 typedef struct pmsgbox_ {
     struct pcb_*    owner;      /**< Pointer to owner PCB */
     pmbox_t         id;         /**< Message box ID */
-    pmsg_t*         recv_msgq;  /**< Pointer to the receive message list queue. */
+    pmsg_t*         recv_msgq[MSG_PRIORITIES];  /**< Receive message queue of every message priority. */
+    bitmap_t        recv_prio;  /**< Message priorities with a non-empty receive queue. */
+    pmsg_t*         src_msgq[BOXID_MAX+1];  /**< Receive queue of every source box (ANY_BOX included). */
     pmsg_t*         wait_msg;   /**< Pointer to a pending receive request message. */
     size_t*         retsize;    /**< pointer to return value of pending receive. */
+    uint8_t         lent[PRIORITY_LEVELS];  /**< Clients blocked on a request to the box, per priority they lend. */
+    bitmap_t        lent_levels[PRIORITY_BITMAP_SIZE];  /**< Priorities lent by at least one client. */
+    uint32_t        depth;      /**< Amount of messages queued. */
+    uint32_t        depth_max;  /**< Limit of messages queued (0 for no limit). */
+    struct pcb_*    send_q;     /**< Senders blocked on the box being full, in the order they blocked. */
+    bool            topic;      /**< Whether messages sent to the box are published to its subscribers. */
+    bitmap_t        subscribers[MSGBOX_BITMAP_SIZE];    /**< Boxes subscribed to the topic. */
 } pmsgbox_t;
 
+/**
+ * @brief   Completion record of an asynchronous send.
+ *          Posted to the box named in the send once the message was sent.
+ */
+typedef struct async_done_ {
+    uint32_t    tag;    /**< Tag given to the send. */
+    pmbox_t     dst;    /**< Destination box of the message. */
+    size_t      size;   /**< Amount of bytes sent. */
+} async_done_t;
+
+/** @brief  Asynchronous send structure. */
+typedef struct async_op_ {
+    union {
+        struct {
+            struct async_op_*   next;
+            struct async_op_*   prev;
+        };
+        node_t list;    /**< List node used for the pending send queue. */
+    };
+
+    pmsg_t          msg;        /**< Message to send. Its data is the sender's buffer. */
+    pmbox_t         notify;     /**< Box the completion record is posted to. */
+    async_done_t    done;       /**< Completion record. */
+    bool            sent;       /**< Whether the message was sent and only the record is pending. */
+    struct pcb_*    owner;      /**< Process that made the send (NULL if the entry is free). */
+} async_op_t;
+
+/**
+ * @brief   Asynchronous request ticket structure.
+ * @details The ticket's ID is carried by the request and by its reply,
+ *          which is held by the ticket until the client waits on it.
+ */
+typedef struct rpc_ticket_ {
+    uint32_t        id;         /**< Ticket ID (TICKET_NONE if the entry is free). */
+    struct pcb_*    client;     /**< Process that made the request. */
+    pmbox_t         client_box; /**< Box the request was sent from. */
+    pmbox_t         server_box; /**< Box the request was sent to. */
+    pmsg_t*         reply;      /**< Reply that arrived before the client waited on it. */
+    bool            dropped;    /**< Whether the client gave up on the reply, so it's discarded when it arrives. */
+} rpc_ticket_t;
+
+/** @brief  Kernel timer structure. */
+typedef struct ktimer_ {
+    union {
+        struct {
+            struct ktimer_* next;
+            struct ktimer_* prev;
+        };
+        node_t list;    /**< List node used for the timer queue. */
+    };
+
+    uint32_t    expires;                    /**< Kernel time when the timer expires. */
+    void        (*expire)(struct ktimer_*); /**< Function called when the timer expires. */
+    void*       arg;                        /**< Argument for the expire function. */
+    uint8_t     lvl;                        /**< Wheel level the timer is placed in. */
+    uint8_t     slot;                       /**< Wheel slot the timer is placed in. */
+} ktimer_t;
+
+/** @brief  User timer structure. */
+typedef struct user_timer_ {
+    ktimer_t        tmr;    /**< Kernel timer driving the user timer. */
+    id_t            id;     /**< Timer ID. Sent to the box when the timer expires. */
+    struct pcb_*    owner;  /**< Process that owns the timer. */
+    pmbox_t         box;    /**< Box notified when the timer expires. */
+    uint32_t        period; /**< Re-arm period in ticks. 0 for one-shot timers. */
+} user_timer_t;
+
 typedef id_t        pid_t;      /// Process id type alias
 typedef uint32_t    priority_t; /// Process priority type alias
 
@@ -56,6 +141,12 @@ typedef struct process_attr_ {
     priority_t  priority;   /**< Process priority. */
     char        name[32];   /**< Process name. */
     void*       arg;        /**< process argument. */
+    uint32_t    quantum;    /**< Time quantum in ms (0 to use the priority's default). */
+    uint32_t    deadline;   /**< Relative deadline in ms. Non-zero places the process in the EDF band. */
+    uint32_t    period;     /**< Release period in ms. Used as the deadline if none is given. */
+    uint32_t    wcet;       /**< Worst-case execution time of a job in ms. Used for admission control. */
+    uint32_t    budget;         /**< CPU budget in ms per budget period (0 for no budget). */
+    uint32_t    budget_period;  /**< Budget replenishment period in ms. */
 } process_attr_t;
 
 /** @brief  Process control block structure */
@@ -70,14 +161,58 @@ typedef struct pcb_ {
 
     pid_t       id;         /**< Process ID. */
     priority_t  priority;   /**< Process priority. */
+    priority_t  base_priority;  /**< Priority the process runs on when it isn't throttled. */
     char        name[32];   /**< Process name. */
     uint32_t    sp_top[STACKSIZE/sizeof(uint32_t)]; /**< Process stack. */
     uint32_t*   sp;         /**< Process stack pointer. */
     int32_t     timer;      /**< Process timer. */
+    uint32_t    quantum;    /**< Time quantum in ms (0 to use the priority's default). */
+    uint32_t    preemptions;    /**< Amount of involuntary context switches. */
     proc_state  state;      /**< Process state */
+    uint32_t    deadline;       /**< Relative deadline in ms (0 for fixed-priority processes). */
+    uint32_t    period;         /**< Release period in ms. */
+    uint32_t    abs_deadline;   /**< Kernel time the current job is due by. */
+    uint32_t    deadline_misses;    /**< Amount of jobs completed past their deadline. */
+    uint32_t    edf_idx;        /**< Position in the EDF ready heap. */
+    uint32_t    utilization;    /**< Admitted CPU utilization (fixed-point, see UTIL_SHIFT). */
+    uint32_t    release;        /**< Kernel time the current job was released at. */
+    bool        job_started;    /**< Whether the current job has been dispatched yet. */
+    uint32_t    jobs;           /**< Amount of jobs completed. */
+    uint32_t    jitter_max;     /**< Longest delay between a release and its job's dispatch. */
+    uint32_t    response_last;  /**< Response time of the last completed job. */
+    uint32_t    response_max;   /**< Longest response time of a job. */
+    uint32_t    budget;         /**< CPU budget in ms per budget period (0 for no budget). */
+    uint32_t    budget_left;    /**< CPU budget left until the next replenishment. */
+    uint32_t    budget_period;  /**< Budget replenishment period in ms. */
+    bool        throttled;      /**< Whether the process exhausted its budget. */
+    pmbox_t     req_box;        /**< Box the process awaits a reply from (BOXID_MAX if none). */
+    priority_t  lent_priority;  /**< Priority lent to the owner of req_box. */
+    bitmap_t    wait_set[MSGBOX_BITMAP_SIZE];   /**< Boxes the process is blocked on in a multi-box receive. */
+    uint32_t    wait_ticket;    /**< Ticket the process is blocked on a reply to (TICKET_NONE if none). */
+    pmsg_t*     reply_slot;     /**< Message slot the awaited reply is copied to. */
+    size_t*     reply_size;     /**< Pointer to return value of the awaited reply. */
+    pmsg_t*     send_msg;       /**< Message the process is blocked on sending to a full box. */
+    size_t*     send_size;      /**< Pointer to return value of the blocked send. */
+    ktimer_t    replenish;      /**< Timer that replenishes the process' budget. */
+    ktimer_t    alarm;      /**< Timer used to wake the process up. */
     bitmap_t    owned_box[MSGBOX_BITMAP_SIZE];      /**< Process owned box' bitmap. */
 } pcb_t;
 
+/**
+ * @brief   Single-producer/single-consumer channel structure.
+ * @details The ring is shared with the channel's processes, which move data
+ *          through it without kernel calls. The kernel only steps in
+ *          to put the consumer to sleep and to wake it back up.
+ */
+typedef struct channel_ {
+    spsc_ring_t ring;       /**< Ring shared with the producer and consumer. */
+    pcb_t*      consumer;   /**< Process that created the channel and reads from it. */
+    pcb_t*      producer;   /**< Process attached to the channel to write to it. */
+    bool        blocked;    /**< Whether the consumer is asleep on the channel. */
+    bool        hung_up;    /**< Whether the producer closed its end since attaching. */
+    uint8_t     buffer[CHANNEL_BUFFER_SIZE];    /**< Ring memory. */
+} channel_t;
+
 typedef void*       k_arg_t;    /// Kernel call argument type alias
 typedef uint32_t    k_ret_t;    /// Kernel call return value type alias
 
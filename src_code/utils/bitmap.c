@@ -4,7 +4,7 @@
  * @brief   Contains all functionality related to operating a bitmap.
  * @author  Manuel Burnay
  * @date    2019.11.22  (Created)
- * @date    2019.11.25  (Last Modified)
+ * @date    2026.10.16  (Last Modified)
  */
 
 
@@ -95,16 +95,24 @@ inline bool GetBit(bitmap_t* bitmap, uint32_t bit)
  */
 inline uint32_t FindSet(bitmap_t* bitmap, uint32_t start, uint32_t end)
 {
-    //todo: implement better algorithm for this
-    // when a large range is search this'll be slow
-    while (start < end) {
-        if (GetBit(bitmap, start))
-            return start;
-        else
-            start++;
+    uint32_t i = start >> BITMAP_INDEX_MASK;
+    bitmap_t entry;
+
+    if (start >= end)   return end;
+
+    // Ignore the bits before start in the first entry
+    entry = bitmap[i] & (0xFFFFFFFF << (start & BITMAP_BIT_MASK));
+
+    // Search a whole entry at a time
+    while (entry == 0) {
+        i++;
+        if ((i << BITMAP_INDEX_MASK) >= end)    return end;
+        entry = bitmap[i];
     }
 
-    return end;
+    start = (i << BITMAP_INDEX_MASK) + LowestSet(entry);
+
+    return (start < end) ? start : end;
 }
 
 /**
@@ -118,12 +126,22 @@ inline uint32_t FindSet(bitmap_t* bitmap, uint32_t start, uint32_t end)
  */
 inline uint32_t FindClear(bitmap_t* bitmap, uint32_t start, uint32_t end)
 {
-    while (start < end) {
-        if (!GetBit(bitmap, start))
-            return start;
-        else
-            start++;
+    uint32_t i = start >> BITMAP_INDEX_MASK;
+    bitmap_t entry;
+
+    if (start >= end)   return end;
+
+    // Ignore the bits before start in the first entry
+    entry = ~bitmap[i] & (0xFFFFFFFF << (start & BITMAP_BIT_MASK));
+
+    // Search a whole entry at a time
+    while (entry == 0) {
+        i++;
+        if ((i << BITMAP_INDEX_MASK) >= end)    return end;
+        entry = ~bitmap[i];
     }
 
-    return end;
+    start = (i << BITMAP_INDEX_MASK) + LowestSet(entry);
+
+    return (start < end) ? start : end;
 }
@@ -5,7 +5,7 @@
  *          operating a bitmap.
  * @author  Manuel Burnay
  * @date    2019.11.22  (Created)
- * @date    2019.11.25  (Last Modified)
+ * @date    2026.10.16  (Last Modified)
  */
 
 #ifndef BITMAP_H
@@ -20,6 +20,32 @@ typedef uint32_t bitmap_t;      /// Bitmap type alias
 #define BITMAP_INDEX_MASK   5   /// Mask to find the position of a bit in the bitmap array. log2(BITMAP_WIDTH).
 #define BITMAP_BIT_MASK     BITMAP_WIDTH-1  /// Mask to find the position of a bit in a bitmap entry.
 
+/** @brief Bitmap array size required to cover a number of bits. */
+#define BITMAP_SIZE(bits)   (((bits) + BITMAP_WIDTH - 1)/BITMAP_WIDTH)
+
+/**
+ * @brief   Counts the leading zeros of a bitmap entry.
+ * @details Maps onto the CPU's CLZ instruction.
+ *          The result is undefined if the entry is 0.
+ */
+#if defined(__TI_ARM__)
+    #define CLZ(x)  _norm(x)
+#else
+    #define CLZ(x)  __builtin_clz(x)
+#endif
+
+/**
+ * @brief   Finds the index of the lowest set bit in a bitmap entry.
+ * @details The result is undefined if the entry is 0.
+ */
+#define LowestSet(x)    ((BITMAP_WIDTH-1) - CLZ((x) & -(x)))
+
+/**
+ * @brief   Finds the index of the highest set bit in a bitmap entry.
+ * @details The result is undefined if the entry is 0.
+ */
+#define HighestSet(x)   ((BITMAP_WIDTH-1) - CLZ(x))
+
 inline void SetBit(bitmap_t* bitmap, uint32_t bit);
 inline void ClearBit(bitmap_t* bitmap, uint32_t bit);
 
@@ -3,7 +3,7 @@
  *	@brief	Has some general functionality/information about the C-M4 cpu.
  *	@author	Manuel Burnay
  *	@date 	2019.09.24	(Created)
- *	@date	2019.09.30	(Last Modified)
+ *	@date	2026.10.16	(Last Modified)
  */
 
 #ifndef CPU_H
@@ -15,6 +15,9 @@
 
 	#define SVC()	__asm(" SVC #0")
 
+	/** @brief Data memory barrier. Orders memory accesses before and after it. */
+	#define DMB()	__asm(" DMB")
+
 	#define F_CPU_CLK	16000000
 
 #endif // CPU_H
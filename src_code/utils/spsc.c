@@ -0,0 +1,102 @@
+/**
+ * @file    spsc.c
+ * @brief   Contains all functionality of the single-producer/single-consumer ring.
+ * @details Memory barriers make sure a slot's contents are written before
+ *          the producer publishes it, and read before the consumer frees it.
+ * @author  Manuel Burnay
+ * @date    2026.10.16 (Created)
+ * @date    2026.10.16 (Last Modified)
+ */
+
+#include <string.h>
+#include "spsc.h"
+#include "cpu.h"
+
+/**
+ * @brief   Initializes a ring.
+ * @param   [out] ring: pointer to ring structure being initialized.
+ * @param   [in] data: Memory for the slots. Has to fit slot_size*slots Bytes.
+ * @param   [in] slot_size: Size of a slot (in Bytes).
+ * @param   [in] slots: Amount of slots. Has to be a power of two.
+ */
+void spsc_init(spsc_ring_t* ring, uint8_t* data, uint32_t slot_size, uint32_t slots)
+{
+    ring->wr_idx = 0;
+    ring->rd_idx = 0;
+    ring->waiting = false;
+    ring->closed = false;
+    ring->mask = slots - 1;
+    ring->slot_size = slot_size;
+    ring->data = data;
+}
+
+/**
+ * @brief   Copies an item into the ring. Only called by the producer.
+ * @param   [in,out] ring: pointer to ring being used.
+ * @param   [in] item: Item to copy. Has to be slot_size Bytes long.
+ * @return  True if the item was queued,
+ *          False if the ring is full or closed.
+ */
+bool spsc_push(spsc_ring_t* ring, const void* item)
+{
+    uint32_t wr = ring->wr_idx;
+
+    if (ring->closed || wr - ring->rd_idx > ring->mask)    return false;
+
+    memcpy(ring->data + (wr & ring->mask)*ring->slot_size, item, ring->slot_size);
+
+    // Slot contents have to be visible before the consumer sees the index move
+    DMB();
+
+    ring->wr_idx = wr + 1;
+
+    return true;
+}
+
+/**
+ * @brief   Copies the oldest item out of the ring. Only called by the consumer.
+ * @param   [in,out] ring: pointer to ring being used.
+ * @param   [out] item: Where the item is copied to. Can be NULL to drop the item.
+ * @return  True if an item was dequeued,
+ *          False if the ring is empty.
+ */
+bool spsc_pop(spsc_ring_t* ring, void* item)
+{
+    uint32_t rd = ring->rd_idx;
+
+    if (rd == ring->wr_idx)    return false;
+
+    // Index has to be read before the slot contents
+    DMB();
+
+    if (item != NULL) {
+        memcpy(item, ring->data + (rd & ring->mask)*ring->slot_size, ring->slot_size);
+    }
+
+    // Slot contents have to be read before the producer can reuse it
+    DMB();
+
+    ring->rd_idx = rd + 1;
+
+    return true;
+}
+
+/**
+ * @brief   Checks if a ring is empty.
+ * @param   [in] ring: pointer to ring being used.
+ * @return  True if no items are queued.
+ */
+inline bool spsc_empty(spsc_ring_t* ring)
+{
+    return (ring->rd_idx == ring->wr_idx);
+}
+
+/**
+ * @brief   Gets how many items are queued in a ring.
+ * @param   [in] ring: pointer to ring being used.
+ * @return  Amount of queued items.
+ */
+inline uint32_t spsc_count(spsc_ring_t* ring)
+{
+    return (ring->wr_idx - ring->rd_idx);
+}
@@ -0,0 +1,43 @@
+/**
+ * @file    spsc.h
+ * @brief   Definitions and function prototypes used to operate a
+ *          lock-free single-producer/single-consumer ring.
+ * @author  Manuel Burnay
+ * @date    2026.10.16 (Created)
+ * @date    2026.10.16 (Last Modified)
+ */
+
+#ifndef SPSC_H
+#define SPSC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief   Single-producer/single-consumer ring structure.
+ * @details The ring holds a power-of-two amount of fixed-size slots.
+ *          The indexes run freely and are only masked when a slot is accessed,
+ *          so the ring can use all of its slots.
+ *          The producer only writes wr_idx and the consumer only writes rd_idx,
+ *          so both sides can work on the ring at the same time without locking.
+ */
+typedef struct spsc_ring_ {
+    volatile uint32_t   wr_idx;     /**< Write index. Only moved by the producer. */
+    volatile uint32_t   rd_idx;     /**< Read index. Only moved by the consumer. */
+    volatile bool       waiting;    /**< Set by the consumer before it sleeps on the ring. */
+    volatile bool       closed;     /**< Set once the consumer is gone. Nothing can be pushed after. */
+    uint32_t            id;         /**< ID of the object the ring belongs to. */
+    uint32_t            mask;       /**< Slot amount - 1. */
+    uint32_t            slot_size;  /**< Size of a slot (in Bytes). */
+    uint8_t*            data;       /**< Pointer to the slots. */
+} spsc_ring_t;
+
+void spsc_init(spsc_ring_t* ring, uint8_t* data, uint32_t slot_size, uint32_t slots);
+
+bool spsc_push(spsc_ring_t* ring, const void* item);
+bool spsc_pop(spsc_ring_t* ring, void* item);
+
+inline bool spsc_empty(spsc_ring_t* ring);
+inline uint32_t spsc_count(spsc_ring_t* ring);
+
+#endif  // SPSC_H